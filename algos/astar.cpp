@@ -1,121 +1,59 @@
 #include "../include/algorithms.h"
-#include "../include/ui_functions.h"
-#include <queue>
-#include <unordered_map>
-#include <map>
-#include <unistd.h>
-#include <ncurses.h>
-#include <cmath>
+#include <cstdlib>
 
-auto compare = [](const std::pair<int, Coordinates> &a, const std::pair<int, Coordinates> &b)
+bool findPathAStar(const Grid &maze, const Coordinates &start, const Coordinates &end, 
+                   std::vector<Coordinates> &path, int &openedNodes, SearchWorkspace& workspace, SearchObserver& observer)
 {
-	return a.first < b.first;
-};
-
-bool findPathAStar(Matrix &maze, const Coordinates &start, const Coordinates &end, 
-                   std::vector<Coordinates> &path, int &openedNodes, double /* delay */, UIState& state)
-{
-	std::unordered_map<Coordinates, Coordinates, CoordinatesHash> parent;
-
-	std::priority_queue<std::pair<int, Coordinates>, std::vector<std::pair<int, Coordinates>>, decltype(compare)> q(compare);
-	std::map<Coordinates, int> g;
-	q.push(std::make_pair(0, start));
-	parent[start] = start;
+	int startId = maze.index(start);
+	int endId = maze.index(end);
+	workspace.reset(maze, true);
+
+	// Keyed by f; among equal f the deeper cell (larger g) goes first, which
+	// walks straight across plateaus instead of fanning out over them
+	BucketQueue<int> &open = workspace.openList(TIES_LARGER_SECONDARY);
+	open.push(std::abs(start.first - end.first) + std::abs(start.second - end.second), startId, 0);
+	workspace.countPush();
+	workspace.markVisited(startId);
+	workspace.cost(startId) = 0;
 	openedNodes++;
 
-	while (!q.empty())
+	while (!open.empty())
 	{
-		// Check for immediate quit first
-		if (state.user_quit) {
-			return false;
-		}
-		
-		// Handle user input
-		int inputResult = handleInput(state);
-		if (inputResult == 0) {
-			return false; // User quit or stopped
-		}
-		if (inputResult == 4) {
-			return false; // Immediate quit
-		}
-		if (inputResult == 2) {
-			drawMaze(maze, state);
-			updateStatus(state);
-			refresh();
-		}
-		
-		// Check for restart request
-		if (state.restart_requested) {
-			return false; // Stop current algorithm to trigger restart
-		}
-		
-		if (!state.running) {
-			usleep(10000); // Small delay when paused
+		int key = open.minKey();
+		int current = open.pop();
+		Coordinates position = maze.coordinates(current);
+		int g = workspace.cost(current);
+		// A cell is pushed again whenever its cost drops; skip the old entries
+		if (key != g + std::abs(position.first - end.first) + std::abs(position.second - end.second))
 			continue;
-		}
-
-		Coordinates current = q.top().second;
-		q.pop();
-		if (current == end)
+		if (current == endId)
 		{
-			Coordinates p = current;
-			while (p != start)
-			{
-				path.push_back(p);
-				p = parent[p];
-			}
-			path.push_back(start);
-			std::reverse(path.begin(), path.end());
-			
-			// Draw final path
-			for (auto p : path) {
-				maze[p.second][p.first] = 2;
-			}
-			maze[start.second][start.first] = -1;
-			maze[end.second][end.first] = -2;
-			drawMaze(maze, state);
-			updateStatus(state);
-			refresh();
+			workspace.reconstructPath(maze, startId, endId, path);
+			observer.onPathFound(maze, path);
 
 			return true;
 		}
 
-		int x = current.first;
-		int y = current.second;
-
-		if (maze[y][x] == 1 || maze[y][x] == 3) // wall or opened
-			continue;
-
 		openedNodes++;
 
-		if (maze[y][x] != -1 && maze[y][x] != -2)
-			maze[y][x] = 3;
-
-		std::vector<std::pair<int, int>> directions = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
-		for (auto d : directions)
+		unsigned moves = maze.openMask(current);
+		for (int d = 0; d < 4; ++d)
 		{
-			int dx = d.first;
-			int dy = d.second;
-			if (x + dx >= 0 && x + dx < (int)maze[0].size() && y + dy >= 0 && y + dy < (int)maze.size())
+			int next = current + maze.offset(d);
+			if ((moves & (1u << d)) && (!workspace.visited(next) || g + 1 < workspace.cost(next)))
 			{
-				Coordinates next = std::make_pair(x + dx, y + dy);
-				if (parent.find(next) == parent.end())
-				{
-					parent[next] = current;
-					g[next] = g[current] + 1;
-					int dx = next.first - end.first;
-					int dy = next.second - end.second;
-					q.push(std::make_pair(-(g[next] + std::abs(dx) + std::abs(dy)), next));
-				}
+				workspace.markVisited(next);
+				workspace.setParent(next, d);
+				workspace.cost(next) = g + 1;
+				int dx = position.first + directions[d].first - end.first;
+				int dy = position.second + directions[d].second - end.second;
+				open.push(g + 1 + std::abs(dx) + std::abs(dy), next, g + 1);
+				workspace.countPush();
 			}
 		}
 
-		// Update display
-		drawMaze(maze, state);
-		state.opened_nodes = openedNodes;
-		updateStatus(state);
-		refresh();
-		handleInputDuringDelay(state, maze, state.speed);
+		if (!observer.onExpand(maze, current, openedNodes))
+			return false;
 	}
 	return false;
-} 
\ No newline at end of file
+}
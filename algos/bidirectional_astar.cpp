@@ -0,0 +1,113 @@
+#include "../include/algorithms.h"
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+
+// One direction of the search: costs and parents in its workspace, the
+// heuristic measured towards its target
+struct SearchSide
+{
+	SearchWorkspace &cells;
+	Coordinates target;
+	// Keyed by f; among equal f the cell furthest from its own side's
+	// origin, which keeps the search on one straight line across open areas
+	BucketQueue<int> &open;
+
+	SearchSide(SearchWorkspace &workspace, const Coordinates &goal)
+		: cells(workspace), target(goal), open(workspace.openList(TIES_LARGER_SECONDARY)) {}
+
+	int heuristic(const Grid &maze, int id) const
+	{
+		Coordinates position = maze.coordinates(id);
+		return std::abs(position.first - target.first) + std::abs(position.second - target.second);
+	}
+
+	// Smallest f still open, or INT_MAX. Entries left behind when a cheaper
+	// path to their cell was found are dropped here.
+	int minF(const Grid &maze)
+	{
+		while (!open.empty() && open.minKey() != cells.cost(open.top()) + heuristic(maze, open.top()))
+			open.pop();
+		return open.empty() ? INT_MAX : open.minKey();
+	}
+};
+
+} // namespace
+
+bool findPathBidirectionalAStar(const Grid &maze, const Coordinates &start, const Coordinates &end,
+                                std::vector<Coordinates> &path, int &openedNodes, SearchWorkspace& workspace, SearchObserver& observer)
+{
+	int startId = maze.index(start);
+	int endId = maze.index(end);
+	workspace.reset(maze, true);
+	workspace.backward().reset(maze, true);
+
+	SearchSide forward(workspace, end);
+	SearchSide backward(workspace.backward(), start);
+	forward.cells.markVisited(startId);
+	forward.cells.cost(startId) = 0;
+	forward.open.push(forward.heuristic(maze, startId), startId, 0);
+	workspace.countPush();
+	backward.cells.markVisited(endId);
+	backward.cells.cost(endId) = 0;
+	backward.open.push(backward.heuristic(maze, endId), endId, 0);
+	workspace.countPush();
+	openedNodes++;
+
+	// Cheapest start-to-end path seen so far and the two cells it joins at
+	int best = startId == endId ? 0 : INT_MAX;
+	int meetForward = startId, meetBackward = endId;
+
+	while (true)
+	{
+		// Each side's smallest f bounds every path not yet seen, so the best
+		// one is optimal once it is no longer than the larger bound
+		int forwardMin = forward.minF(maze);
+		int backwardMin = backward.minF(maze);
+		if (forwardMin == INT_MAX || backwardMin == INT_MAX || best <= std::max(forwardMin, backwardMin))
+			break;
+
+		bool isForward = best == INT_MAX ? forward.open.size() <= backward.open.size() : forwardMin >= backwardMin;
+		SearchSide &side = isForward ? forward : backward;
+		SearchSide &other = isForward ? backward : forward;
+		int current = side.open.pop();
+		openedNodes++;
+
+		unsigned open = maze.openMask(current);
+		int cost = side.cells.cost(current) + 1;
+		for (int d = 0; d < 4; ++d)
+		{
+			int next = current + maze.offset(d);
+			if (!(open & (1u << d)))
+				continue;
+			if ((!side.cells.visited(next) || cost < side.cells.cost(next)) && cost + side.heuristic(maze, next) < best)
+			{
+				side.cells.markVisited(next);
+				side.cells.setParent(next, d);
+				side.cells.cost(next) = cost;
+				side.open.push(cost + side.heuristic(maze, next), next, cost);
+				workspace.countPush();
+			}
+			if (other.cells.visited(next) && cost + other.cells.cost(next) < best)
+			{
+				best = cost + other.cells.cost(next);
+				meetForward = isForward ? current : next;
+				meetBackward = isForward ? next : current;
+			}
+		}
+
+		if (!observer.onExpand(maze, current, openedNodes))
+			return false;
+	}
+
+	if (best == INT_MAX)
+		return false;
+
+	workspace.reconstructPath(maze, startId, meetForward, meetBackward, endId, path);
+	observer.onPathFound(maze, path);
+	return true;
+}
@@ -0,0 +1,101 @@
+#include "../include/algorithms.h"
+
+namespace
+{
+
+enum LayerResult
+{
+	LAYER_DONE,
+	LAYER_MET,
+	LAYER_ABORTED
+};
+
+// Expand every cell of one side's frontier, collecting the next layer in
+// next. Stops at the first neighbour already reached by the other side:
+// both sides are always expanded whole layers at a time, so that meeting
+// closes a shortest path.
+LayerResult expandLayer(const Grid &maze, const SearchWorkspace::CellList &frontier, SearchWorkspace::CellList &next,
+                        SearchWorkspace &near, const SearchWorkspace &far, int &meetNear, int &meetFar,
+                        int &openedNodes, SearchObserver &observer)
+{
+	next.clear();
+	for (int current : frontier)
+	{
+		openedNodes++;
+		unsigned open = maze.openMask(current);
+		for (int d = 0; d < 4; ++d)
+		{
+			int neighbour = current + maze.offset(d);
+			if (!(open & (1u << d)))
+				continue;
+			if (far.visited(neighbour))
+			{
+				meetNear = current;
+				meetFar = neighbour;
+				return LAYER_MET;
+			}
+			if (!near.visited(neighbour))
+			{
+				near.markVisited(neighbour);
+				near.setParent(neighbour, d);
+				next.push_back(neighbour);
+			}
+		}
+
+		if (!observer.onExpand(maze, current, openedNodes))
+			return LAYER_ABORTED;
+	}
+	return LAYER_DONE;
+}
+
+} // namespace
+
+bool findPathBidirectionalBFS(const Grid &maze, const Coordinates &start, const Coordinates &end,
+                              std::vector<Coordinates> &path, int &openedNodes, SearchWorkspace& workspace, SearchObserver& observer)
+{
+	int startId = maze.index(start);
+	int endId = maze.index(end);
+	SearchWorkspace &backward = workspace.backward();
+	workspace.reset(maze);
+	backward.reset(maze);
+
+	workspace.markVisited(startId);
+	backward.markVisited(endId);
+	workspace.countPush(2);
+	openedNodes++;
+	if (startId == endId)
+	{
+		workspace.reconstructPath(maze, startId, endId, path);
+		observer.onPathFound(maze, path);
+		return true;
+	}
+
+	SearchWorkspace::CellList forwardFrontier(1, startId, workspace.frontierAllocator());
+	SearchWorkspace::CellList backwardFrontier(1, endId, workspace.frontierAllocator());
+	SearchWorkspace::CellList next(workspace.frontierAllocator());
+	while (!forwardFrontier.empty() && !backwardFrontier.empty())
+	{
+		// Grow the smaller frontier
+		bool forward = forwardFrontier.size() <= backwardFrontier.size();
+		int meetNear = -1, meetFar = -1;
+		LayerResult result = forward
+			? expandLayer(maze, forwardFrontier, next, workspace, backward, meetNear, meetFar, openedNodes, observer)
+			: expandLayer(maze, backwardFrontier, next, backward, workspace, meetNear, meetFar, openedNodes, observer);
+
+		workspace.countPush(static_cast<long long>(next.size()));
+		workspace.noteFrontier(next.size() + (forward ? backwardFrontier : forwardFrontier).size());
+		if (result == LAYER_ABORTED)
+			return false;
+		if (result == LAYER_MET)
+		{
+			int forwardId = forward ? meetNear : meetFar;
+			int backwardId = forward ? meetFar : meetNear;
+			workspace.reconstructPath(maze, startId, forwardId, backwardId, endId, path);
+			observer.onPathFound(maze, path);
+
+			return true;
+		}
+		(forward ? forwardFrontier : backwardFrontier).swap(next);
+	}
+	return false;
+}
@@ -0,0 +1,155 @@
+#include "../include/algorithms.h"
+#include "../include/corridor_graph.h"
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+
+namespace
+{
+
+int manhattanDistance(const Coordinates &a, const Coordinates &b)
+{
+	return std::abs(a.first - b.first) + std::abs(a.second - b.second);
+}
+
+// Search nodes are junction indices, plus these two for a start or end
+// inside a corridor
+const int kStartNode = -1;
+const int kEndNode = -2;
+
+// A corridor end that leads to the end cell when the end is not a junction
+struct EndLink
+{
+	int node;
+	int cost;
+};
+
+} // namespace
+
+bool findPathCorridorAStar(const Grid &maze, const Coordinates &start, const Coordinates &end,
+                           std::vector<Coordinates> &path, int &openedNodes, SearchWorkspace& workspace, SearchObserver& observer)
+{
+	int startId = maze.index(start);
+	int endId = maze.index(end);
+
+	// Prepared mazes carry their graph; others pay for building one here
+	std::shared_ptr<const CorridorGraph> local;
+	const CorridorGraph *graph = maze.corridorGraph();
+	if (graph == nullptr)
+	{
+		local = std::make_shared<CorridorGraph>(maze);
+		graph = local.get();
+	}
+	if (!graph->kept(startId) || !graph->kept(endId))
+		return findPathAStar(maze, start, end, path, openedNodes, workspace, observer);
+
+	workspace.reset(maze, true, true);
+	int startNode = graph->isJunction(startId) ? graph->junctionAt(startId) : kStartNode;
+	int endNode = graph->isJunction(endId) ? graph->junctionAt(endId) : kEndNode;
+	auto cellOf = [&](int node) { return node >= 0 ? graph->junctionCell(node) : node == kStartNode ? startId : endId; };
+	auto nodeOf = [&](int cell) { return cell == startId ? startNode : cell == endId ? endNode : graph->junctionAt(cell); };
+
+	std::vector<EndLink> endLinks;
+	if (endNode == kEndNode)
+	{
+		for (int d = 0; d < 4; ++d)
+		{
+			EndLink link;
+			int reached = (graph->keptMask(endId) & (1u << d)) ? graph->walk(maze, endId, d, startId, link.cost) : endId;
+			if (reached != endId)
+			{
+				link.node = nodeOf(reached);
+				endLinks.push_back(link);
+			}
+		}
+	}
+
+	// Keyed by f over junctions; a whole corridor is one step, so costs
+	// grow by its length. Workspace arrays are indexed by cell as usual.
+	BucketQueue<int> &open = workspace.openList(TIES_LARGER_SECONDARY);
+	auto relax = [&](int from, int g, int toNode, int cost)
+	{
+		int to = cellOf(toNode);
+		if (workspace.visited(to) && g + cost >= workspace.cost(to))
+			return;
+		workspace.markVisited(to);
+		workspace.cost(to) = g + cost;
+		workspace.jumpParent(to) = from;
+		open.push(g + cost + manhattanDistance(maze.coordinates(to), end), toNode, g + cost);
+		workspace.countPush();
+	};
+	relax(startId, 0, startNode, 0);
+
+	while (!open.empty())
+	{
+		int key = open.minKey();
+		int node = open.pop();
+		int current = cellOf(node);
+		int g = workspace.cost(current);
+		// Junctions are pushed again whenever their cost drops
+		if (key != g + manhattanDistance(maze.coordinates(current), end))
+			continue;
+		if (current == endId)
+			break;
+
+		openedNodes++;
+		if (node >= 0)
+		{
+			for (int edge = graph->edgesBegin(node); edge != graph->edgesEnd(node); ++edge)
+				relax(current, g, graph->edgeTarget(edge), graph->edgeCost(edge));
+		}
+		else
+		{
+			// A start inside a corridor reaches the junctions at both ends,
+			// or the end if it lies on the same corridor
+			for (int d = 0; d < 4; ++d)
+			{
+				int cost = 0;
+				int reached = (graph->keptMask(current) & (1u << d)) ? graph->walk(maze, current, d, endId, cost) : current;
+				if (reached != current)
+					relax(current, g, nodeOf(reached), cost);
+			}
+		}
+		for (const EndLink &link : endLinks)
+		{
+			if (link.node == node)
+				relax(current, g, kEndNode, link.cost);
+		}
+
+		if (!observer.onExpand(maze, current, openedNodes))
+			return false;
+	}
+	if (!workspace.visited(endId))
+		return false;
+
+	std::vector<int> waypoints(1, endId);
+	while (waypoints.back() != startId)
+		waypoints.push_back(workspace.jumpParent(waypoints.back()));
+	std::reverse(waypoints.begin(), waypoints.end());
+
+	// Walk each corridor back out: of the corridors leaving a waypoint, the
+	// one reaching the next waypoint at the recorded cost
+	path.assign(1, start);
+	for (std::size_t i = 1; i < waypoints.size(); ++i)
+	{
+		int from = waypoints[i - 1];
+		int to = waypoints[i];
+		int hop = workspace.cost(to) - workspace.cost(from);
+		int d = 0;
+		for (int cost = 0; d < 4; ++d)
+		{
+			if ((graph->keptMask(from) & (1u << d)) && graph->walk(maze, from, d, to, cost) == to && cost == hop)
+				break;
+		}
+		for (int cell = from; cell != to;)
+		{
+			cell += maze.offset(d);
+			path.push_back(maze.coordinates(cell));
+			if (cell != to)
+				d = __builtin_ctz(graph->keptMask(cell) & ~(1u << (d ^ 1)));
+		}
+	}
+
+	observer.onPathFound(maze, path);
+	return true;
+}
@@ -0,0 +1,19 @@
+#include "../include/algorithms.h"
+#include "../include/d_star_lite.h"
+
+// A from-scratch D* Lite run; the planner's incremental repairs after wall
+// edits are driven by the maze editor and --edits instead
+bool findPathDStarLite(const Grid &maze, const Coordinates &start, const Coordinates &end,
+                       std::vector<Coordinates> &path, int &openedNodes, SearchWorkspace& workspace, SearchObserver& observer)
+{
+	workspace.reset(maze);
+	DStarLite planner(maze, maze.index(start), maze.index(end), workspace.parentCounter(), workspace.frontierCounter());
+	bool planned = planner.plan(observer, openedNodes);
+	workspace.countPush(planner.pushes());
+	workspace.noteFrontier(planner.peakOpen());
+	if (!planned || !planner.path(path))
+		return false;
+
+	observer.onPathFound(maze, path);
+	return true;
+}
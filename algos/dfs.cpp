@@ -1,109 +1,46 @@
 #include "../include/algorithms.h"
-#include "../include/ui_functions.h"
-#include <stack>
-#include <map>
-#include <unistd.h>
-#include <ncurses.h>
-#include <utility>
 
-bool findPathDFS(Matrix &maze, const Coordinates &start, const Coordinates &end, 
-                    std::vector<Coordinates> &path, int &openedNodes, double /* delay */, UIState& state)
+bool findPathDFS(const Grid &maze, const Coordinates &start, const Coordinates &end, 
+                    std::vector<Coordinates> &path, int &openedNodes, SearchWorkspace& workspace, SearchObserver& observer)
 {
-	std::stack<Coordinates> s;
-	std::map<Coordinates, Coordinates> parent;
-	s.push(start);
-	parent[start] = start;
+	int startId = maze.index(start);
+	int endId = maze.index(end);
+	workspace.reset(maze);
+
+	// Single-key LIFO open list: a stack whose storage the workspace keeps
+	BucketQueue<int> &s = workspace.openList(TIES_LIFO);
+	s.push(0, startId);
+	workspace.countPush();
+	workspace.markVisited(startId);
 	openedNodes++;
 
 	while (!s.empty())
 	{
-		// Check for immediate quit first
-		if (state.user_quit) {
-			return false;
-		}
-		
-		// Handle user input
-		int inputResult = handleInput(state);
-		if (inputResult == 0) {
-			return false; // User quit or stopped
-		}
-		if (inputResult == 4) {
-			return false; // Immediate quit
-		}
-		if (inputResult == 2) {
-			drawMaze(maze, state);
-			updateStatus(state);
-			refresh();
-		}
-		
-		// Check for restart request
-		if (state.restart_requested) {
-			return false; // Stop current algorithm to trigger restart
-		}
-		
-		if (!state.running) {
-			usleep(10000); // Small delay when paused
-			continue;
-		}
-
-		Coordinates current = s.top();
-		s.pop();
-		if (current == end)
+		int current = s.pop();
+		if (current == endId)
 		{
-			Coordinates p = current;
-			while (p != start)
-			{
-				path.push_back(p);
-				p = parent[p];
-			}
-			path.push_back(start);
-			std::reverse(path.begin(), path.end());
-			
-			// Draw final path
-			for (auto p : path) {
-				maze[p.second][p.first] = 2;
-			}
-			maze[start.second][start.first] = -1;
-			maze[end.second][end.first] = -2;
-			drawMaze(maze, state);
-			updateStatus(state);
-			refresh();
+			workspace.reconstructPath(maze, startId, endId, path);
+			observer.onPathFound(maze, path);
 
 			return true;
 		}
 
-		int x = current.first;
-		int y = current.second;
-
-		if (maze[y][x] == 1 || maze[y][x] == 3) // wall or opened
-		{
-			continue;
-		}
 		openedNodes++;
-		if (maze[y][x] != -1 && maze[y][x] != -2)
-			maze[y][x] = 3;
 
-		for (auto it = directions.rbegin(); it != directions.rend(); ++it) {
-			const auto& d = *it;
-			int dx = d.first;
-			int dy = d.second;
-			if (x + dx >= 0 && x + dx < (int)maze[0].size() && y + dy >= 0 && y + dy < (int)maze.size())
+		unsigned open = maze.openMask(current);
+		for (int d = 3; d >= 0; --d) {
+			int next = current + maze.offset(d);
+			if ((open & (1u << d)) && !workspace.visited(next))
 			{
-				Coordinates next = std::make_pair(x + dx, y + dy);
-				if (parent.find(next) == parent.end())
-				{
-					parent[next] = current;
-					s.push(next);
-				}
+				workspace.markVisited(next);
+				workspace.setParent(next, d);
+				s.push(0, next);
+				workspace.countPush();
 			}
 		}
 
-		// Update display
-		drawMaze(maze, state);
-		state.opened_nodes = openedNodes;
-		updateStatus(state);
-		refresh();
-		handleInputDuringDelay(state, maze, state.speed);
+		if (!observer.onExpand(maze, current, openedNodes))
+			return false;
 	}
 	return false;
-} 
+}
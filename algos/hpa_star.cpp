@@ -0,0 +1,177 @@
+#include "../include/algorithms.h"
+#include "../include/abstract_graph.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+
+namespace
+{
+
+std::atomic<int> clusterSize(AbstractGraph::kDefaultClusterSize);
+
+int manhattanDistance(const Coordinates &a, const Coordinates &b)
+{
+	return std::abs(a.first - b.first) + std::abs(a.second - b.second);
+}
+
+// A* over the abstract graph plus the start and end cells. Start is joined
+// to the entrances of its cluster and every cell of the end's cluster to
+// the end, using BFS distances within those two clusters.
+class AbstractSearch
+{
+public:
+	AbstractSearch(const Grid &maze, const AbstractGraph &graph, SearchWorkspace &workspace, int startId, int endId)
+		: maze_(maze), graph_(graph), workspace_(workspace), startId_(startId), endId_(endId),
+		  end_(maze.coordinates(endId)), startArea_(graph.bounds(graph.clusterOf(maze.coordinates(startId)))),
+		  endArea_(graph.bounds(graph.clusterOf(end_))),
+		  open_(workspace.openList(TIES_LARGER_SECONDARY))
+	{
+	}
+
+	/// Run the search; false when the end cannot be reached or the
+	/// observer aborts
+	bool run(int &openedNodes, SearchObserver &observer)
+	{
+		openedNodes += floodCluster(maze_, startArea_, startId_, startDistances_);
+		openedNodes += floodCluster(maze_, endArea_, endId_, endDistances_);
+
+		workspace_.markVisited(startId_);
+		workspace_.cost(startId_) = 0;
+		workspace_.jumpParent(startId_) = startId_;
+		open_.push(manhattanDistance(maze_.coordinates(startId_), end_), startId_, 0);
+		workspace_.countPush();
+
+		while (!open_.empty())
+		{
+			int key = open_.minKey();
+			int current = open_.pop();
+			Coordinates position = maze_.coordinates(current);
+			int g = workspace_.cost(current);
+			// Nodes are pushed again whenever their cost drops
+			if (key != g + manhattanDistance(position, end_))
+				continue;
+			if (current == endId_)
+				return true;
+
+			openedNodes++;
+			if (current == startId_)
+			{
+				for (const int *node = graph_.clusterNodesBegin(graph_.clusterOf(position));
+				     node != graph_.clusterNodesEnd(graph_.clusterOf(position)); ++node)
+				{
+					int cell = graph_.nodeCell(*node);
+					int distance = startDistances_[startArea_.local(maze_.coordinates(cell))];
+					if (distance > 0)
+						relax(current, g, cell, distance);
+				}
+			}
+			int node = graph_.nodeAt(current);
+			if (node >= 0)
+			{
+				for (int edge = graph_.edgesBegin(node); edge != graph_.edgesEnd(node); ++edge)
+					relax(current, g, graph_.nodeCell(graph_.edgeTarget(edge)), graph_.edgeCost(edge));
+			}
+			if (endArea_.contains(position))
+			{
+				int distance = endDistances_[endArea_.local(position)];
+				if (distance > 0)
+					relax(current, g, endId_, distance);
+			}
+
+			if (!observer.onExpand(maze_, current, openedNodes))
+				return false;
+		}
+		return false;
+	}
+
+private:
+	void relax(int from, int g, int to, int cost)
+	{
+		if (workspace_.visited(to) && g + cost >= workspace_.cost(to))
+			return;
+		workspace_.markVisited(to);
+		workspace_.cost(to) = g + cost;
+		workspace_.jumpParent(to) = from;
+		open_.push(g + cost + manhattanDistance(maze_.coordinates(to), end_), to, g + cost);
+		workspace_.countPush();
+	}
+
+	const Grid &maze_;
+	const AbstractGraph &graph_;
+	SearchWorkspace &workspace_;
+	int startId_;
+	int endId_;
+	Coordinates end_;
+	ClusterBounds startArea_;
+	ClusterBounds endArea_;
+	BucketQueue<int> &open_;
+	std::vector<int> startDistances_;
+	std::vector<int> endDistances_;
+};
+
+} // namespace
+
+int hpaClusterSize()
+{
+	return clusterSize.load(std::memory_order_relaxed);
+}
+
+void setHpaClusterSize(int size)
+{
+	clusterSize.store(size > 0 ? size : AbstractGraph::kDefaultClusterSize, std::memory_order_relaxed);
+}
+
+bool findPathHPAStar(const Grid &maze, const Coordinates &start, const Coordinates &end,
+                     std::vector<Coordinates> &path, int &openedNodes, SearchWorkspace& workspace, SearchObserver& observer)
+{
+	int startId = maze.index(start);
+	int endId = maze.index(end);
+	workspace.reset(maze, true, true);
+
+	// Prepared mazes carry their graph; others pay for building one here
+	std::shared_ptr<const AbstractGraph> local;
+	const AbstractGraph *graph = maze.abstractGraph();
+	if (graph == nullptr)
+	{
+		local = std::make_shared<AbstractGraph>(maze, hpaClusterSize());
+		graph = local.get();
+	}
+
+	AbstractSearch search(maze, *graph, workspace, startId, endId);
+	if (!search.run(openedNodes, observer))
+		return false;
+
+	// Abstract route, end to start
+	std::vector<int> waypoints(1, endId);
+	while (waypoints.back() != startId)
+		waypoints.push_back(workspace.jumpParent(waypoints.back()));
+	std::reverse(waypoints.begin(), waypoints.end());
+
+	// Refine each hop: neighbours are joined directly, every other hop lies
+	// within the cluster of its first cell
+	path.assign(1, start);
+	std::vector<int> distances;
+	std::vector<std::uint8_t> parents;
+	std::vector<Coordinates> segment;
+	for (std::size_t i = 1; i < waypoints.size(); ++i)
+	{
+		int from = waypoints[i - 1];
+		int to = waypoints[i];
+		Coordinates target = maze.coordinates(to);
+		if (manhattanDistance(maze.coordinates(from), target) == 1)
+		{
+			path.push_back(target);
+			continue;
+		}
+		ClusterBounds area = graph->bounds(graph->clusterOf(maze.coordinates(from)));
+		openedNodes += floodCluster(maze, area, from, distances, &parents, to);
+		segment.clear();
+		for (int cell = to; cell != from; cell -= maze.offset(parents[area.local(maze.coordinates(cell))]))
+			segment.push_back(maze.coordinates(cell));
+		path.insert(path.end(), segment.rbegin(), segment.rend());
+	}
+
+	observer.onPathFound(maze, path);
+	return true;
+}
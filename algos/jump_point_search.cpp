@@ -0,0 +1,159 @@
+#include "../include/algorithms.h"
+#include "../include/jump_table.h"
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+
+const int LEFT = 0;
+const int UP = 2;
+const int DOWN = 3;
+
+// Cell a vertical jump from `from` stops at, or -1 when it runs into a wall
+int jumpVertical(const Grid &maze, int from, int d, int endId)
+{
+	int step = maze.offset(d);
+	for (int id = from; maze.openMask(id) & (1u << d);)
+	{
+		id += step;
+		if (id == endId || forcedNeighbours(maze, id, d))
+			return id;
+	}
+	return -1;
+}
+
+// Cell a horizontal jump stops at: the first one from which a vertical jump
+// finds something
+int jumpHorizontal(const Grid &maze, int from, int d, int endId)
+{
+	int step = maze.offset(d);
+	for (int id = from; maze.openMask(id) & (1u << d);)
+	{
+		id += step;
+		if (id == endId || jumpVertical(maze, id, UP, endId) >= 0 || jumpVertical(maze, id, DOWN, endId) >= 0)
+			return id;
+	}
+	return -1;
+}
+
+// The same jumps read from a JumpTable. The table knows nothing about the
+// goal, so stops caused by it are worked out here.
+int tableJumpVertical(const Grid &maze, const JumpTable &table, int from, const Coordinates &position, int d,
+                      const Coordinates &end, int endId)
+{
+	int distance = table.distance(from, d);
+	int ahead = d == UP ? position.second - end.second : end.second - position.second;
+	if (position.first == end.first && ahead > 0 && ahead <= std::abs(distance))
+		return endId;
+	return distance > 0 ? from + distance * maze.offset(d) : -1;
+}
+
+int tableJumpHorizontal(const Grid &maze, const JumpTable &table, int from, const Coordinates &position, int d,
+                        const Coordinates &end)
+{
+	int distance = table.distance(from, d);
+	int ahead = d == LEFT ? position.first - end.first : end.first - position.first;
+	if (ahead > 0 && ahead <= std::abs(distance))
+	{
+		// Passing the goal's column: stop there if the goal is in a straight
+		// line from it
+		int cell = from + ahead * maze.offset(d);
+		int rise = end.second - position.second;
+		if (rise == 0 || ahead == distance || -table.distance(cell, rise < 0 ? UP : DOWN) >= std::abs(rise))
+			return cell;
+	}
+	return distance > 0 ? from + distance * maze.offset(d) : -1;
+}
+
+// Directions worth jumping in from a cell reached by moving in direction d
+unsigned prunedMoves(const Grid &maze, int id, int d)
+{
+	if (d < UP)
+		return (1u << d) | (1u << UP) | (1u << DOWN);
+	return (1u << d) | forcedNeighbours(maze, id, d);
+}
+
+// A* over jump points. With a table the jumps are table lookups (JPS+),
+// without one they scan the grid.
+bool searchJumpPoints(const Grid &maze, const JumpTable *table, const Coordinates &start, const Coordinates &end,
+                      std::vector<Coordinates> &path, int &openedNodes, SearchWorkspace &workspace, SearchObserver &observer)
+{
+	int startId = maze.index(start);
+	int endId = maze.index(end);
+	workspace.reset(maze, true, true);
+
+	// Keyed by f, ties go to the larger g
+	BucketQueue<int> &open = workspace.openList(TIES_LARGER_SECONDARY);
+	open.push(std::abs(start.first - end.first) + std::abs(start.second - end.second), startId, 0);
+	workspace.countPush();
+	workspace.markVisited(startId);
+	workspace.cost(startId) = 0;
+	workspace.jumpParent(startId) = startId;
+	openedNodes++;
+
+	while (!open.empty())
+	{
+		int key = open.minKey();
+		int current = open.pop();
+		Coordinates position = maze.coordinates(current);
+		int g = workspace.cost(current);
+		if (key != g + std::abs(position.first - end.first) + std::abs(position.second - end.second))
+			continue;
+		if (current == endId)
+		{
+			workspace.reconstructJumpPath(maze, startId, endId, path);
+			observer.onPathFound(maze, path);
+
+			return true;
+		}
+
+		openedNodes++;
+
+		unsigned moves = current == startId ? 15u : prunedMoves(maze, current, workspace.parentDirection(current));
+		for (int d = 0; d < 4; ++d)
+		{
+			if (!(moves & (1u << d)))
+				continue;
+			int next;
+			if (table != nullptr)
+				next = d < UP ? tableJumpHorizontal(maze, *table, current, position, d, end)
+				              : tableJumpVertical(maze, *table, current, position, d, end, endId);
+			else
+				next = d < UP ? jumpHorizontal(maze, current, d, endId) : jumpVertical(maze, current, d, endId);
+			if (next < 0)
+				continue;
+
+			Coordinates nextPosition = maze.coordinates(next);
+			int cost = g + std::abs(nextPosition.first - position.first) + std::abs(nextPosition.second - position.second);
+			if (!workspace.visited(next) || cost < workspace.cost(next))
+			{
+				workspace.markVisited(next);
+				workspace.setParent(next, d);
+				workspace.jumpParent(next) = current;
+				workspace.cost(next) = cost;
+				int heuristic = std::abs(nextPosition.first - end.first) + std::abs(nextPosition.second - end.second);
+				open.push(cost + heuristic, next, cost);
+				workspace.countPush();
+			}
+		}
+
+		if (!observer.onExpand(maze, current, openedNodes))
+			return false;
+	}
+	return false;
+}
+
+} // namespace
+
+bool findPathJPS(const Grid &maze, const Coordinates &start, const Coordinates &end,
+                 std::vector<Coordinates> &path, int &openedNodes, SearchWorkspace& workspace, SearchObserver& observer)
+{
+	return searchJumpPoints(maze, nullptr, start, end, path, openedNodes, workspace, observer);
+}
+
+bool findPathJPSPlus(const Grid &maze, const Coordinates &start, const Coordinates &end,
+                     std::vector<Coordinates> &path, int &openedNodes, SearchWorkspace& workspace, SearchObserver& observer)
+{
+	return searchJumpPoints(maze, maze.jumpTable(), start, end, path, openedNodes, workspace, observer);
+}
@@ -0,0 +1,206 @@
+#include "../include/algorithms.h"
+#include "../include/parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+namespace
+{
+
+// Levels with a smaller frontier are expanded on the calling thread alone;
+// waking the team costs more than they do
+const int kParallelFrontier = 4096;
+
+// Work a thread claims at a time: frontier cells top-down, rows bottom-up
+const int kFrontierChunk = 512;
+const int kRowChunk = 8;
+
+// Direction switching as in Beamer's direction-optimizing BFS: go
+// bottom-up once the frontier holds more than 1/kAlpha of the cells not
+// reached yet, and back top-down once it holds less than 1/kBeta of all
+// cells. On mazes the frontier seldom grows that large, so most levels
+// run top-down.
+const long long kAlpha = 14;
+const long long kBeta = 24;
+
+// One bit per cell, set for the cells of a bottom-up level's frontier
+typedef std::vector<std::uint64_t, CountingAllocator<std::uint64_t>> FrontierBits;
+
+// One BFS level shared by the team. Each thread appends the cells it
+// claims to its own buffer in next.
+
+struct Level
+{
+	const Grid *maze;
+	SearchWorkspace *workspace;
+	const SearchWorkspace::CellList *frontier;
+	const FrontierBits *inFrontier;
+	std::vector<SearchWorkspace::CellList> *next;
+	std::atomic<int> cursor;
+};
+
+// Claim the unvisited neighbours of the frontier cells. Levels expanded by
+// the calling thread alone skip the atomic updates.
+template <bool shared>
+void expandTopDown(Level &level, int thread)
+{
+	const Grid &maze = *level.maze;
+	const SearchWorkspace::CellList &frontier = *level.frontier;
+	SearchWorkspace::CellList &next = (*level.next)[thread];
+	const int size = static_cast<int>(frontier.size());
+	for (int first = level.cursor.fetch_add(kFrontierChunk); first < size; first = level.cursor.fetch_add(kFrontierChunk))
+	{
+		int last = std::min(first + kFrontierChunk, size);
+		for (int i = first; i < last; ++i)
+		{
+			int current = frontier[i];
+			unsigned open = maze.openMask(current);
+			for (int d = 0; d < 4; ++d)
+			{
+				int cell = current + maze.offset(d);
+				if (!(open & (1u << d)))
+					continue;
+				if (shared)
+				{
+					if (level.workspace->claimVisited(cell, d))
+						next.push_back(cell);
+				}
+				else if (!level.workspace->visited(cell))
+				{
+					level.workspace->markVisited(cell);
+					level.workspace->setParent(cell, d);
+					next.push_back(cell);
+				}
+			}
+		}
+	}
+}
+
+// Let every open cell not reached yet look for a parent in the frontier
+void expandBottomUp(Level &level, int thread)
+{
+	const Grid &maze = *level.maze;
+	const FrontierBits &inFrontier = *level.inFrontier;
+	SearchWorkspace::CellList &next = (*level.next)[thread];
+	const int height = maze.height();
+	for (int first = level.cursor.fetch_add(kRowChunk); first < height; first = level.cursor.fetch_add(kRowChunk))
+	{
+		int last = std::min(first + kRowChunk, height);
+		for (int y = first; y < last; ++y)
+		{
+			int rowEnd = maze.index(maze.width(), y);
+			for (int cell = maze.index(0, y); cell < rowEnd; ++cell)
+			{
+				if (maze[cell] == CELL_WALL || level.workspace->claimed(cell))
+					continue;
+				// The parent reached by moving d lies in direction d ^ 1
+				unsigned open = maze.openMask(cell);
+				for (int d = 0; d < 4; ++d)
+				{
+					int parent = cell - maze.offset(d);
+					if ((open & (1u << (d ^ 1))) && ((inFrontier[parent >> 6] >> (parent & 63)) & 1u))
+					{
+						level.workspace->claimVisited(cell, d);
+						next.push_back(cell);
+						break;
+					}
+				}
+			}
+		}
+	}
+}
+
+} // namespace
+
+bool findPathParallelBFS(const Grid &maze, const Coordinates &start, const Coordinates &end,
+                         std::vector<Coordinates> &path, int &openedNodes, SearchWorkspace& workspace, SearchObserver& observer)
+{
+	int startId = maze.index(start);
+	int endId = maze.index(end);
+	workspace.reset(maze);
+
+	workspace.markVisited(startId);
+	workspace.countPush();
+	openedNodes++;
+
+	const long long cells = static_cast<long long>(maze.width()) * maze.height();
+	long long reached = 1;
+	SearchWorkspace::CellList frontier(1, startId, workspace.frontierAllocator());
+	std::vector<SearchWorkspace::CellList> next(workerCount(), SearchWorkspace::CellList(workspace.frontierAllocator()));
+	FrontierBits inFrontier(workspace.frontierAllocator());
+	std::unique_ptr<WorkerTeam> team;
+	bool bottomUp = false;
+
+	while (!frontier.empty() && !workspace.visited(endId))
+	{
+		long long size = static_cast<long long>(frontier.size());
+		bottomUp = bottomUp ? size * kBeta >= cells : size * kAlpha > cells - reached;
+		if (bottomUp)
+		{
+			inFrontier.resize((maze.cellCount() + 63) / 64);
+			for (int cell : frontier)
+				inFrontier[cell >> 6] |= std::uint64_t(1) << (cell & 63);
+		}
+
+		Level level;
+		level.maze = &maze;
+		level.workspace = &workspace;
+		level.frontier = &frontier;
+		level.inFrontier = &inFrontier;
+		level.next = &next;
+		level.cursor.store(0);
+		if (next.size() > 1 && (bottomUp || size >= kParallelFrontier))
+		{
+			// Threads are started on the first level worth sharing and kept
+			// for the rest of the search
+			if (!team)
+				team.reset(new WorkerTeam(static_cast<int>(next.size())));
+			team->run([&level, bottomUp](int thread)
+			{
+				if (bottomUp)
+					expandBottomUp(level, thread);
+				else
+					expandTopDown<true>(level, thread);
+			});
+		}
+		else if (bottomUp)
+		{
+			expandBottomUp(level, 0);
+		}
+		else
+		{
+			expandTopDown<false>(level, 0);
+		}
+
+		if (bottomUp)
+		{
+			for (int cell : frontier)
+				inFrontier[cell >> 6] = 0;
+		}
+
+		// Observers are not thread-safe, so they see the level's cells
+		// expanded once the whole level is done
+		for (int cell : frontier)
+		{
+			openedNodes++;
+			if (!observer.onExpand(maze, cell, openedNodes))
+				return false;
+		}
+
+		frontier.clear();
+		for (SearchWorkspace::CellList &buffer : next)
+		{
+			frontier.insert(frontier.end(), buffer.begin(), buffer.end());
+			buffer.clear();
+		}
+		reached += static_cast<long long>(frontier.size());
+		workspace.countPush(static_cast<long long>(frontier.size()));
+		workspace.noteFrontier(frontier.size());
+	}
+
+	if (!workspace.visited(endId))
+		return false;
+	workspace.reconstructPath(maze, startId, endId, path);
+	observer.onPathFound(maze, path);
+	return true;
+}
@@ -1,116 +1,56 @@
 #include "../include/algorithms.h"
-#include "../include/ui_functions.h"
 #include <vector>
-#include <map>
-#include <queue>
 #include <random>
 #include <algorithm>
-#include <unistd.h>
-#include <ncurses.h>
-#include <ctime>
 
-bool findPathRandomSearch(Matrix& maze, const Coordinates& start, const Coordinates& end,
-                         std::vector<Coordinates>& path, int& openedNodes, double /* delay */, UIState& state) {
-	std::map<Coordinates, Coordinates> parent;
-	std::queue<Coordinates> q;
+bool findPathRandomSearch(const Grid& maze, const Coordinates& start, const Coordinates& end,
+                         std::vector<Coordinates>& path, int& openedNodes, SearchWorkspace& workspace, SearchObserver& observer) {
+	int startId = maze.index(start);
+	int endId = maze.index(end);
+	workspace.reset(maze);
+
+	// Single-key FIFO open list: a queue whose storage the workspace keeps
+	BucketQueue<int> &q = workspace.openList(TIES_FIFO);
 	std::random_device rd;
 	std::mt19937 gen(rd());
-	q.push(start);
-	parent[start] = start;
+	q.push(0, startId);
+	workspace.countPush();
+	workspace.markVisited(startId);
 	openedNodes = 1;
 	
 	while (!q.empty()) {
-		// Check for immediate quit first
-		if (state.user_quit) {
-			return false;
-		}
+		int current = q.pop();
 		
-		int inputResult = handleInput(state);
-		if (inputResult == 0) {
-			return false;
-		}
-		if (inputResult == 4) {
-			return false; // Immediate quit
-		}
-		if (inputResult == 2) {
-			drawMaze(maze, state);
-			updateStatus(state);
-			refresh();
-		}
-		
-		// Check for restart request
-		if (state.restart_requested) {
-			return false; // Stop current algorithm to trigger restart
-		}
-		
-		if (!state.running) {
-			usleep(10000);
-			continue;
-		}
-		
-		Coordinates current = q.front();
-		q.pop();
-		
-		if (current == end) {
-			Coordinates p = current;
-			while (p != start) {
-				path.push_back(p);
-				p = parent[p];
-			}
-			path.push_back(start);
-			std::reverse(path.begin(), path.end());
-			for (const auto& p : path) {
-				maze[p.second][p.first] = 2;
-			}
-			maze[start.second][start.first] = -1;
-			maze[end.second][end.first] = -2;
-			drawMaze(maze, state);
-			updateStatus(state);
-			refresh();
+		if (current == endId) {
+			workspace.reconstructPath(maze, startId, endId, path);
+			observer.onPathFound(maze, path);
 			return true;
 		}
 		
-		int x = current.first;
-		int y = current.second;
-		
-		if (maze[y][x] == 1 || maze[y][x] == 3) {
-			continue;
-		}
-		
 		openedNodes++;
-		if (maze[y][x] != -1 && maze[y][x] != -2) {
-			maze[y][x] = 3;
-		}
 		
-		std::vector<Coordinates> unvisitedNeighbors;
-		for (const auto& direction : directions) {
-			int dx = direction.first;
-			int dy = direction.second;
-			int newX = x + dx;
-			int newY = y + dy;
-			if (newX >= 0 && newX < static_cast<int>(maze[0].size()) && 
-				newY >= 0 && newY < static_cast<int>(maze.size())) {
-				Coordinates neighbor = std::make_pair(newX, newY);
-				if (parent.find(neighbor) == parent.end()) {
-					unvisitedNeighbors.push_back(neighbor);
-				}
+		int unvisitedDirections[4];
+		int unvisitedCount = 0;
+		unsigned open = maze.openMask(current);
+		for (int d = 0; d < 4; ++d) {
+			if ((open & (1u << d)) && !workspace.visited(current + maze.offset(d))) {
+				unvisitedDirections[unvisitedCount++] = d;
 			}
 		}
 		
 		// Randomly shuffle and add all unvisited neighbors
-		if (!unvisitedNeighbors.empty()) {
-			std::shuffle(unvisitedNeighbors.begin(), unvisitedNeighbors.end(), gen);
-			for (const auto& neighbor : unvisitedNeighbors) {
-				parent[neighbor] = current;
-				q.push(neighbor);
-			}
+		std::shuffle(unvisitedDirections, unvisitedDirections + unvisitedCount, gen);
+		for (int i = 0; i < unvisitedCount; ++i) {
+			int d = unvisitedDirections[i];
+			int neighbor = current + maze.offset(d);
+			workspace.markVisited(neighbor);
+			workspace.setParent(neighbor, d);
+			q.push(0, neighbor);
+			workspace.countPush();
 		}
 		
-		drawMaze(maze, state);
-		state.opened_nodes = openedNodes;
-		updateStatus(state);
-		refresh();
-		handleInputDuringDelay(state, maze, state.speed);
+		if (!observer.onExpand(maze, current, openedNodes))
+			return false;
 	}
 	return false;
-} 
\ No newline at end of file
+}
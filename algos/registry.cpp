@@ -0,0 +1,53 @@
+#include "../include/algorithms.h"
+
+namespace {
+
+void buildJumpTable(Grid& maze, const std::string&) {
+    maze.buildJumpTable();
+}
+
+void buildCorridorGraph(Grid& maze, const std::string&) {
+    maze.buildCorridorGraph();
+}
+
+// Saved as FILE.hpa next to the maze, so later loads skip building it
+void buildAbstractGraph(Grid& maze, const std::string& mazeFile) {
+    maze.buildAbstractGraph(mazeFile.empty() ? mazeFile : mazeFile + ".hpa", hpaClusterSize());
+}
+
+} // namespace
+
+const std::vector<AlgorithmInfo>& availableAlgorithms() {
+    static const std::vector<AlgorithmInfo> algorithms = {
+        {"BFS", "bfs", findPathBFS, "", nullptr, true},
+        {"DFS", "dfs", findPathDFS, "", nullptr, false},
+        {"Random Search", "random", findPathRandomSearch, "", nullptr, false},
+        {"Greedy Search", "greedy", findPathGreedySearch, "", nullptr, false},
+        {"A*", "astar", findPathAStar, "", nullptr, true},
+        {"Bidirectional BFS", "bibfs", findPathBidirectionalBFS, "bfs", nullptr, true},
+        {"Bidirectional A*", "biastar", findPathBidirectionalAStar, "astar", nullptr, true},
+        {"Jump Point Search", "jps", findPathJPS, "astar", nullptr, true},
+        {"JPS+", "jpsplus", findPathJPSPlus, "astar", buildJumpTable, true},
+        {"Parallel BFS", "pbfs", findPathParallelBFS, "bfs", nullptr, true},
+        {"HPA*", "hpa", findPathHPAStar, "astar", buildAbstractGraph, false},
+        {"Corridor A*", "corridor", findPathCorridorAStar, "astar", buildCorridorGraph, true},
+        {"D* Lite", "dstar", findPathDStarLite, "astar", nullptr, true},
+    };
+    return algorithms;
+}
+
+int findAlgorithm(const std::string& key) {
+    const std::vector<AlgorithmInfo>& algorithms = availableAlgorithms();
+    for (std::size_t i = 0; i < algorithms.size(); ++i) {
+        if (algorithms[i].key == key) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+void prepareMaze(const AlgorithmInfo& algorithm, Grid& maze, const std::string& mazeFile) {
+    if (algorithm.prepare != nullptr && !maze.empty()) {
+        algorithm.prepare(maze, mazeFile);
+    }
+}
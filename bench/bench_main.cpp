@@ -0,0 +1,492 @@
+// Headless benchmark harness: runs every engine over every maze and
+// reports wall time, ns per expanded node, nodes opened, open-list pushes,
+// path length, peak RSS and the search's own memory as CSV and JSON. --compare diffs two CSV reports so regressions
+// show up between commits.
+//
+// Usage:
+//   ./maze_bench [options] [maze files...]        (default: dataset/*.txt)
+//     --algo KEY[,KEY...]   engines to run, e.g. bfs,astar (default: all)
+//     --repeat N            timed repetitions per maze/engine (default: 5)
+//     --warmup N            untimed runs before timing (default: 1)
+//     --csv FILE            write the results as CSV
+//     --json FILE           write the results as JSON
+//     --scaling N           time the engines (default: pbfs) on 1..N worker
+//                           threads instead, N = 0 for every core
+//     --cluster N           HPA* cluster size (default: 16)
+//   A maze named gen:STYLE:WxH[:SEED] (e.g. gen:kruskal:4001x4001:7) is
+//   generated in memory instead of read from a file.
+//   ./maze_bench --compare BASELINE.csv CURRENT.csv [--threshold PCT]
+
+#include "../include/algorithms.h"
+#include "../include/maze_generator.h"
+#include "../include/maze_loader.h"
+#include "../include/parallel.h"
+#include "../include/resource_usage.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <glob.h>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct BenchOptions {
+    std::vector<std::string> mazes;
+    std::vector<int> algorithms;
+    int repetitions;
+    int warmup;
+    std::string csvFile;
+    std::string jsonFile;
+    int scalingThreads;     ///< Largest thread count of a --scaling run, or -1
+};
+
+struct BenchResult {
+    std::string maze;
+    std::string algorithm;
+    int repetitions;
+    bool found;
+    std::size_t pathLength;
+    int openedNodes;
+    double medianMs;
+    double minMs;
+    double nsPerNode;
+    long peakRssKb;
+    long long pushes;
+    std::size_t searchPeakBytes;    ///< Parent store and frontier at their largest
+    long long runAllocations;       ///< Allocations of the last timed run
+    std::size_t peakFrontier;
+};
+
+const char* kCsvHeader = "maze,algorithm,repetitions,found,path_length,opened_nodes,median_ms,min_ms,ns_per_node,peak_rss_kb,pushes,"
+                         "search_peak_bytes,run_allocations,peak_frontier";
+
+void printUsage(const char* program) {
+    std::fprintf(stderr,
+                 "Usage: %s [--algo KEY[,KEY...]] [--repeat N] [--warmup N] [--csv FILE] [--json FILE]\n"
+                 "          [--scaling N] [--cluster N] [mazes...]\n"
+                 "       %s --compare BASELINE.csv CURRENT.csv [--threshold PCT]\n",
+                 program, program);
+}
+
+const char* kGeneratedPrefix = "gen:";
+
+bool isGenerated(const std::string& mazeName) {
+    return mazeName.compare(0, std::strlen(kGeneratedPrefix), kGeneratedPrefix) == 0;
+}
+
+// A maze file, or a maze generated from a gen: spec
+Grid loadBenchMaze(const std::string& mazeName, Coordinates& start, Coordinates& end) {
+    if (!isGenerated(mazeName)) {
+        return readMaze(mazeName, start, end);
+    }
+    GeneratorOptions generator;
+    if (!parseGeneratorSpec(mazeName.substr(std::strlen(kGeneratedPrefix)), generator)) {
+        std::fprintf(stderr, "Bad maze spec %s, expected gen:STYLE:WxH[:SEED]\n", mazeName.c_str());
+        return Grid();
+    }
+    return generateGrid(generator, start, end);
+}
+
+// Generated mazes have no file to keep precomputed data next to
+std::string cacheFile(const std::string& mazeName) {
+    return isGenerated(mazeName) ? std::string() : mazeName;
+}
+
+// dataset/2.txt sorts before dataset/10.txt
+bool naturalLess(const std::string& a, const std::string& b) {
+    return a.size() != b.size() ? a.size() < b.size() : a < b;
+}
+
+std::vector<std::string> defaultMazes() {
+    std::vector<std::string> mazes;
+    glob_t matches;
+    if (glob("dataset/*.txt", 0, nullptr, &matches) == 0) {
+        for (std::size_t i = 0; i < matches.gl_pathc; ++i) {
+            mazes.push_back(matches.gl_pathv[i]);
+        }
+    }
+    globfree(&matches);
+    std::sort(mazes.begin(), mazes.end(), naturalLess);
+    return mazes;
+}
+
+bool parseAlgorithms(const std::string& list, std::vector<int>& algorithms) {
+    std::istringstream stream(list);
+    std::string key;
+    while (std::getline(stream, key, ',')) {
+        int index = findAlgorithm(key);
+        if (index < 0) {
+            std::fprintf(stderr, "Unknown algorithm '%s'\n", key.c_str());
+            return false;
+        }
+        algorithms.push_back(index);
+    }
+    return true;
+}
+
+double median(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    std::size_t middle = values.size() / 2;
+    return values.size() % 2 ? values[middle] : (values[middle - 1] + values[middle]) / 2.0;
+}
+
+BenchResult runOne(const std::string& mazeName, const Grid& maze, const Coordinates& start,
+                   const Coordinates& end, const AlgorithmInfo& algorithm, const BenchOptions& options) {
+    SearchWorkspace workspace;
+    NullSearchObserver observer;
+
+    BenchResult result;
+    result.maze = mazeName;
+    result.algorithm = algorithm.key;
+    result.repetitions = options.repetitions;
+    result.found = false;
+    result.pathLength = 0;
+    result.openedNodes = 0;
+    result.peakRssKb = 0;
+    result.pushes = 0;
+    result.searchPeakBytes = 0;
+    result.runAllocations = 0;
+    result.peakFrontier = 0;
+
+    std::vector<double> timings;
+    for (int run = 0; run < options.warmup + options.repetitions; ++run) {
+        std::vector<Coordinates> path;
+        int openedNodes = 0;
+
+        resetPeakRss();
+        auto startTime = std::chrono::steady_clock::now();
+        bool found = algorithm.run(maze, start, end, path, openedNodes, workspace, observer);
+        double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+        long peak = peakRssKb();
+
+        if (run < options.warmup) {
+            continue;
+        }
+        timings.push_back(elapsedMs);
+        result.found = found;
+        result.pathLength = path.size();
+        result.openedNodes = openedNodes;
+        result.peakRssKb = std::max(result.peakRssKb, peak);
+        result.pushes = workspace.pushes();
+
+        // Only the first run sizes the workspace, so later ones should
+        // allocate nothing unless the engine keeps buffers of its own
+        RunMemory memory;
+        workspace.memoryUsage(maze, path, memory);
+        result.searchPeakBytes = memory.parents.peakBytes + memory.frontier.peakBytes;
+        result.runAllocations = memory.parents.allocations + memory.frontier.allocations;
+        result.peakFrontier = memory.peakFrontier;
+    }
+
+    result.medianMs = median(timings);
+    result.minMs = *std::min_element(timings.begin(), timings.end());
+    result.nsPerNode = result.openedNodes > 0 ? result.medianMs * 1e6 / result.openedNodes : 0.0;
+    return result;
+}
+
+std::string jsonString(const std::string& value) {
+    std::string escaped = "\"";
+    for (char c : value) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped + "\"";
+}
+
+bool writeCsv(const std::string& filename, const std::vector<BenchResult>& results) {
+    std::FILE* file = std::fopen(filename.c_str(), "w");
+    if (file == nullptr) {
+        std::fprintf(stderr, "Could not write %s\n", filename.c_str());
+        return false;
+    }
+    std::fprintf(file, "%s\n", kCsvHeader);
+    for (const BenchResult& r : results) {
+        std::fprintf(file, "%s,%s,%d,%d,%zu,%d,%.6f,%.6f,%.2f,%ld,%lld,%zu,%lld,%zu\n", r.maze.c_str(),
+                     r.algorithm.c_str(), r.repetitions, r.found ? 1 : 0, r.pathLength, r.openedNodes, r.medianMs,
+                     r.minMs, r.nsPerNode, r.peakRssKb, r.pushes, r.searchPeakBytes, r.runAllocations,
+                     r.peakFrontier);
+    }
+    return std::fclose(file) == 0;
+}
+
+bool writeJson(const std::string& filename, const std::vector<BenchResult>& results) {
+    std::FILE* file = std::fopen(filename.c_str(), "w");
+    if (file == nullptr) {
+        std::fprintf(stderr, "Could not write %s\n", filename.c_str());
+        return false;
+    }
+    std::fprintf(file, "[\n");
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& r = results[i];
+        std::fprintf(file,
+                     "  {\"maze\": %s, \"algorithm\": %s, \"repetitions\": %d, \"found\": %s, "
+                     "\"path_length\": %zu, \"opened_nodes\": %d, \"median_ms\": %.6f, \"min_ms\": %.6f, "
+                     "\"ns_per_node\": %.2f, \"peak_rss_kb\": %ld, \"pushes\": %lld, "
+                     "\"search_peak_bytes\": %zu, \"run_allocations\": %lld, \"peak_frontier\": %zu}%s\n",
+                     jsonString(r.maze).c_str(), jsonString(r.algorithm).c_str(), r.repetitions,
+                     r.found ? "true" : "false", r.pathLength, r.openedNodes, r.medianMs, r.minMs,
+                     r.nsPerNode, r.peakRssKb, r.pushes, r.searchPeakBytes, r.runAllocations, r.peakFrontier,
+                     i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(file, "]\n");
+    return std::fclose(file) == 0;
+}
+
+// Nodes and pushes each variant engine saved over its baseline engine on the
+// same maze
+void printBaselineSavings(const std::vector<BenchResult>& results) {
+    bool printedHeader = false;
+    for (const BenchResult& variant : results) {
+        const AlgorithmInfo& info = availableAlgorithms()[findAlgorithm(variant.algorithm)];
+        for (const BenchResult& base : results) {
+            if (info.baseline.empty() || base.maze != variant.maze || base.algorithm != info.baseline) {
+                continue;
+            }
+            if (!printedHeader) {
+                std::printf("\n%-18s %-14s %-10s %10s %10s %8s %10s %10s %8s\n", "maze", "algorithm", "baseline",
+                            "opened", "base open", "saved", "pushes", "base push", "saved");
+                printedHeader = true;
+            }
+            double savedPct = base.openedNodes > 0
+                ? (base.openedNodes - variant.openedNodes) * 100.0 / base.openedNodes : 0.0;
+            double pushesSavedPct = base.pushes > 0 ? (base.pushes - variant.pushes) * 100.0 / base.pushes : 0.0;
+            std::printf("%-18s %-14s %-10s %10d %10d %7.1f%% %10lld %10lld %7.1f%%\n", variant.maze.c_str(),
+                        variant.algorithm.c_str(), base.algorithm.c_str(), variant.openedNodes, base.openedNodes,
+                        savedPct, variant.pushes, base.pushes, pushesSavedPct);
+        }
+    }
+}
+
+int runBenchmarks(const BenchOptions& options) {
+    const std::vector<AlgorithmInfo>& algorithms = availableAlgorithms();
+    std::vector<BenchResult> results;
+
+    std::printf("%-18s %-14s %6s %8s %10s %10s %12s %12s %10s %10s %7s\n", "maze", "algorithm", "found", "length",
+                "opened", "pushes", "median ms", "ns/node", "peak KB", "search KB", "allocs");
+    for (const std::string& mazeName : options.mazes) {
+        Coordinates start, end;
+        Grid maze = loadBenchMaze(mazeName, start, end);
+        if (maze.empty()) {
+            std::fprintf(stderr, "Skipping %s\n", mazeName.c_str());
+            continue;
+        }
+        for (int index : options.algorithms) {
+            // Precomputation happens at load time, outside the timed runs
+            prepareMaze(algorithms[index], maze, cacheFile(mazeName));
+            BenchResult result = runOne(mazeName, maze, start, end, algorithms[index], options);
+            std::printf("%-18s %-14s %6s %8zu %10d %10lld %12.4f %12.1f %10ld %10zu %7lld\n", result.maze.c_str(),
+                        result.algorithm.c_str(), result.found ? "yes" : "no", result.pathLength,
+                        result.openedNodes, result.pushes, result.medianMs, result.nsPerNode, result.peakRssKb,
+                        result.searchPeakBytes / 1024, result.runAllocations);
+            results.push_back(result);
+        }
+    }
+
+    printBaselineSavings(results);
+
+    bool ok = true;
+    if (!options.csvFile.empty()) {
+        ok = writeCsv(options.csvFile, results) && ok;
+    }
+    if (!options.jsonFile.empty()) {
+        ok = writeJson(options.jsonFile, results) && ok;
+    }
+    return ok ? 0 : 1;
+}
+
+// Speed-up of each engine on 1..N threads over its own single-thread time
+int runScaling(const BenchOptions& options) {
+    const std::vector<AlgorithmInfo>& algorithms = availableAlgorithms();
+    setWorkerCount(0);
+    int maxThreads = options.scalingThreads > 0 ? options.scalingThreads : workerCount();
+
+    std::printf("%-18s %-14s %8s %10s %12s %10s %11s\n", "maze", "algorithm", "threads", "opened", "median ms",
+                "speed-up", "efficiency");
+    for (const std::string& mazeName : options.mazes) {
+        Coordinates start, end;
+        Grid maze = loadBenchMaze(mazeName, start, end);
+        if (maze.empty()) {
+            std::fprintf(stderr, "Skipping %s\n", mazeName.c_str());
+            continue;
+        }
+        for (int index : options.algorithms) {
+            prepareMaze(algorithms[index], maze, cacheFile(mazeName));
+            double singleMs = 0.0;
+            for (int threads = 1; threads <= maxThreads; ++threads) {
+                setWorkerCount(threads);
+                BenchResult result = runOne(mazeName, maze, start, end, algorithms[index], options);
+                if (threads == 1) {
+                    singleMs = result.medianMs;
+                }
+                double speedup = result.medianMs > 0 ? singleMs / result.medianMs : 0.0;
+                std::printf("%-18s %-14s %8d %10d %12.4f %9.2fx %10.0f%%\n", result.maze.c_str(),
+                            result.algorithm.c_str(), threads, result.openedNodes, result.medianMs, speedup,
+                            speedup * 100.0 / threads);
+            }
+        }
+    }
+    setWorkerCount(0);
+    return 0;
+}
+
+bool readCsv(const std::string& filename, std::map<std::string, BenchResult>& results,
+             std::vector<std::string>& order) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        std::fprintf(stderr, "Could not open %s\n", filename.c_str());
+        return false;
+    }
+    std::string line;
+    std::getline(file, line);  // Header
+    while (std::getline(file, line)) {
+        std::vector<std::string> fields;
+        std::istringstream stream(line);
+        std::string field;
+        while (std::getline(stream, field, ',')) {
+            fields.push_back(field);
+        }
+        if (fields.size() < 10) {
+            continue;
+        }
+        BenchResult r;
+        r.maze = fields[0];
+        r.algorithm = fields[1];
+        r.repetitions = std::atoi(fields[2].c_str());
+        r.found = fields[3] == "1";
+        r.pathLength = static_cast<std::size_t>(std::atol(fields[4].c_str()));
+        r.openedNodes = std::atoi(fields[5].c_str());
+        r.medianMs = std::atof(fields[6].c_str());
+        r.minMs = std::atof(fields[7].c_str());
+        r.nsPerNode = std::atof(fields[8].c_str());
+        r.peakRssKb = std::atol(fields[9].c_str());
+        r.pushes = fields.size() > 10 ? std::atoll(fields[10].c_str()) : 0;  // Older reports lack it
+        bool hasMemory = fields.size() > 13;
+        r.searchPeakBytes = hasMemory ? static_cast<std::size_t>(std::atoll(fields[11].c_str())) : 0;
+        r.runAllocations = hasMemory ? std::atoll(fields[12].c_str()) : 0;
+        r.peakFrontier = hasMemory ? static_cast<std::size_t>(std::atoll(fields[13].c_str())) : 0;
+        std::string key = r.maze + "," + r.algorithm;
+        if (results.find(key) == results.end()) {
+            order.push_back(key);
+        }
+        results[key] = r;
+    }
+    return true;
+}
+
+int compareReports(const std::string& baselineFile, const std::string& currentFile, double thresholdPct) {
+    std::map<std::string, BenchResult> baseline, current;
+    std::vector<std::string> baselineOrder, currentOrder;
+    if (!readCsv(baselineFile, baseline, baselineOrder) || !readCsv(currentFile, current, currentOrder)) {
+        return 2;
+    }
+
+    // Differences below this are timer noise on tiny mazes
+    const double noiseFloorMs = 0.05;
+    int regressions = 0;
+    std::printf("%-18s %-14s %12s %12s %9s %10s %10s  %s\n", "maze", "algorithm", "base ms", "current ms",
+                "delta", "base open", "open", "status");
+    for (const std::string& key : currentOrder) {
+        const BenchResult& now = current[key];
+        std::map<std::string, BenchResult>::const_iterator before = baseline.find(key);
+        if (before == baseline.end()) {
+            std::printf("%-18s %-14s %12s %12.4f %9s %10s %10d  new\n", now.maze.c_str(), now.algorithm.c_str(),
+                        "-", now.medianMs, "-", "-", now.openedNodes);
+            continue;
+        }
+        const BenchResult& base = before->second;
+        double deltaPct = base.medianMs > 0 ? (now.medianMs - base.medianMs) * 100.0 / base.medianMs : 0.0;
+        const char* status = "ok";
+        if (deltaPct > thresholdPct && now.medianMs - base.medianMs > noiseFloorMs) {
+            status = "REGRESSION";
+            ++regressions;
+        } else if (deltaPct < -thresholdPct && base.medianMs - now.medianMs > noiseFloorMs) {
+            status = "faster";
+        }
+        if (base.found != now.found || (base.found && base.pathLength != now.pathLength && base.algorithm != "random")) {
+            status = "RESULT CHANGED";
+            ++regressions;
+        }
+        std::printf("%-18s %-14s %12.4f %12.4f %+8.1f%% %10d %10d  %s\n", now.maze.c_str(), now.algorithm.c_str(),
+                    base.medianMs, now.medianMs, deltaPct, base.openedNodes, now.openedNodes, status);
+    }
+    for (const std::string& key : baselineOrder) {
+        if (current.find(key) == current.end()) {
+            std::printf("%-18s %-14s missing from %s\n", baseline[key].maze.c_str(), baseline[key].algorithm.c_str(),
+                        currentFile.c_str());
+        }
+    }
+
+    std::printf("%d regression(s) above %.1f%%\n", regressions, thresholdPct);
+    return regressions > 0 ? 1 : 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BenchOptions options;
+    options.repetitions = 5;
+    options.warmup = 1;
+    options.scalingThreads = -1;
+    std::string compareBaseline, compareCurrent;
+    double thresholdPct = 10.0;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--algo" && hasValue) {
+            if (!parseAlgorithms(argv[++i], options.algorithms)) {
+                return 2;
+            }
+        } else if (arg == "--repeat" && hasValue) {
+            options.repetitions = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--warmup" && hasValue) {
+            options.warmup = std::max(0, std::atoi(argv[++i]));
+        } else if (arg == "--csv" && hasValue) {
+            options.csvFile = argv[++i];
+        } else if (arg == "--json" && hasValue) {
+            options.jsonFile = argv[++i];
+        } else if (arg == "--scaling" && hasValue) {
+            options.scalingThreads = std::max(0, std::atoi(argv[++i]));
+        } else if (arg == "--cluster" && hasValue) {
+            setHpaClusterSize(std::atoi(argv[++i]));
+        } else if (arg == "--compare" && i + 2 < argc) {
+            compareBaseline = argv[++i];
+            compareCurrent = argv[++i];
+        } else if (arg == "--threshold" && hasValue) {
+            thresholdPct = std::atof(argv[++i]);
+        } else if (arg == "--help" || arg == "-h" || arg.compare(0, 2, "--") == 0) {
+            printUsage(argv[0]);
+            return arg == "--help" || arg == "-h" ? 0 : 2;
+        } else {
+            options.mazes.push_back(arg);
+        }
+    }
+
+    if (!compareBaseline.empty()) {
+        return compareReports(compareBaseline, compareCurrent, thresholdPct);
+    }
+
+    if (options.mazes.empty()) {
+        options.mazes = defaultMazes();
+    }
+    if (options.scalingThreads >= 0) {
+        if (options.algorithms.empty()) {
+            options.algorithms.push_back(findAlgorithm("pbfs"));
+        }
+        return runScaling(options);
+    }
+    if (options.algorithms.empty()) {
+        for (std::size_t i = 0; i < availableAlgorithms().size(); ++i) {
+            options.algorithms.push_back(static_cast<int>(i));
+        }
+    }
+    return runBenchmarks(options);
+}
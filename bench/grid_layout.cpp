@@ -0,0 +1,116 @@
+// Compares the flat padded Grid against the previous vector<vector<int>>
+// maze layout: memory footprint and a full BFS flood from the start cell.
+//
+// Usage: ./grid_layout_bench [maze file] [repetitions]
+
+#include "../include/grid.h"
+#include "../include/maze_loader.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using LegacyMatrix = std::vector<std::vector<int>>;
+
+static LegacyMatrix toLegacy(const Grid& grid) {
+    LegacyMatrix maze(grid.height(), std::vector<int>(grid.width(), 0));
+    for (int y = 0; y < grid.height(); ++y) {
+        for (int x = 0; x < grid.width(); ++x) {
+            maze[y][x] = grid.at(x, y);
+        }
+    }
+    return maze;
+}
+
+// BFS flood the way the engines used to walk the matrix: double indirection
+// and four bounds checks per neighbour.
+static long floodLegacy(const LegacyMatrix& maze, const Coordinates& start) {
+    int height = static_cast<int>(maze.size());
+    int width = static_cast<int>(maze[0].size());
+    std::vector<std::vector<int>> dist(height, std::vector<int>(width, -1));
+    std::vector<Coordinates> queue;
+    queue.reserve(static_cast<std::size_t>(width) * height);
+    queue.push_back(start);
+    dist[start.second][start.first] = 0;
+    long checksum = 0;
+    for (std::size_t head = 0; head < queue.size(); ++head) {
+        Coordinates current = queue[head];
+        int d = dist[current.second][current.first];
+        checksum += d;
+        for (const auto& dir : directions) {
+            int nx = current.first + dir.first;
+            int ny = current.second + dir.second;
+            if (nx >= 0 && nx < width && ny >= 0 && ny < height &&
+                maze[ny][nx] != CELL_WALL && dist[ny][nx] < 0) {
+                dist[ny][nx] = d + 1;
+                queue.push_back(Coordinates(nx, ny));
+            }
+        }
+    }
+    return checksum;
+}
+
+// Same flood over the padded grid: one id per cell, neighbours from the
+// precomputed open mask, no bounds checks.
+static long floodGrid(const Grid& grid, const Coordinates& start) {
+    std::vector<int> dist(grid.cellCount(), -1);
+    std::vector<int> queue;
+    queue.reserve(static_cast<std::size_t>(grid.width()) * grid.height());
+    int startId = grid.index(start);
+    queue.push_back(startId);
+    dist[startId] = 0;
+    long checksum = 0;
+    for (std::size_t head = 0; head < queue.size(); ++head) {
+        int id = queue[head];
+        int d = dist[id];
+        checksum += d;
+        unsigned open = grid.openMask(id);
+        for (int dir = 0; dir < 4; ++dir) {
+            int next = id + grid.offset(dir);
+            if ((open & (1u << dir)) && dist[next] < 0) {
+                dist[next] = d + 1;
+                queue.push_back(next);
+            }
+        }
+    }
+    return checksum;
+}
+
+template <typename F>
+static double bestOf(int repetitions, F fn, long& result) {
+    double best = 1e30;
+    for (int i = 0; i < repetitions; ++i) {
+        auto t0 = std::chrono::steady_clock::now();
+        result = fn();
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        if (ms < best) best = ms;
+    }
+    return best;
+}
+
+int main(int argc, char** argv) {
+    std::string filename = argc > 1 ? argv[1] : "dataset/11.txt";
+    int repetitions = argc > 2 ? std::atoi(argv[2]) : 10;
+
+    Coordinates start, end;
+    Grid grid = readMaze(filename, start, end);
+    if (grid.empty()) {
+        return 1;
+    }
+    LegacyMatrix legacy = toLegacy(grid);
+
+    std::size_t legacyBytes = sizeof(LegacyMatrix) + legacy.size() * (sizeof(std::vector<int>) + legacy[0].size() * sizeof(int));
+    std::size_t gridBytes = sizeof(Grid) + static_cast<std::size_t>(grid.cellCount()) * 2;  // cell + open mask
+
+    long legacyResult = 0, gridResult = 0;
+    double legacyMs = bestOf(repetitions, [&]() { return floodLegacy(legacy, start); }, legacyResult);
+    double gridMs = bestOf(repetitions, [&]() { return floodGrid(grid, start); }, gridResult);
+
+    std::printf("maze: %s (%dx%d)\n", filename.c_str(), grid.width(), grid.height());
+    std::printf("%-22s %12s %8s %12s\n", "layout", "bytes", "allocs", "flood ms");
+    std::printf("%-22s %12zu %8zu %12.3f\n", "vector<vector<int>>", legacyBytes, legacy.size() + 1, legacyMs);
+    std::printf("%-22s %12zu %8d %12.3f\n", "Grid (padded, 1 byte)", gridBytes, 2, gridMs);
+    std::printf("speed-up: %.2fx, checksums %s\n", legacyMs / gridMs, legacyResult == gridResult ? "match" : "DIFFER");
+    return legacyResult == gridResult ? 0 : 1;
+}
@@ -0,0 +1,100 @@
+#ifndef ABSTRACT_GRAPH_H
+#define ABSTRACT_GRAPH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "grid.h"
+
+// One square cluster of the maze, cells [x0, x1) x [y0, y1)
+struct ClusterBounds {
+    int x0, y0, x1, y1;
+
+    bool contains(const Coordinates& c) const {
+        return c.first >= x0 && c.first < x1 && c.second >= y0 && c.second < y1;
+    }
+    int width() const { return x1 - x0; }
+    int cellCount() const { return (x1 - x0) * (y1 - y0); }
+
+    /// Index of maze cell c in per-cluster arrays (row order)
+    int local(const Coordinates& c) const { return (c.second - y0) * (x1 - x0) + (c.first - x0); }
+};
+
+/// BFS from sourceId that never leaves bounds. distances receives, per
+/// cell of the cluster in local() order, the moves from the source or -1;
+/// parents, if given, the direction of the move that reached each cell.
+/// Stops early once stopId (if not -1) is reached. Returns the number of
+/// cells expanded.
+int floodCluster(const Grid& maze, const ClusterBounds& bounds, int sourceId, std::vector<int>& distances,
+                 std::vector<std::uint8_t>* parents = nullptr, int stopId = -1);
+
+// Abstract graph for hierarchical pathfinding (HPA*). The maze is cut into
+// square clusters; wherever two neighbouring clusters share a run of open
+// cells along their border, that run is an entrance with one or two
+// transitions, each a pair of facing cells joined by an edge of cost 1.
+// Inside each cluster, the transition cells are joined by edges weighted
+// with their shortest distance within the cluster. Nodes are transition
+// cells, edges are stored per node in CSR form.
+class AbstractGraph {
+public:
+    static const int kDefaultClusterSize = 16;
+
+    explicit AbstractGraph(const Grid& maze, int clusterSize = kDefaultClusterSize);
+
+    /// Read a graph written by save() for a maze with these walls (see
+    /// hashWalls()); null if the file is missing, unreadable or was written
+    /// for other walls or another cluster size
+    static std::shared_ptr<AbstractGraph> load(const std::string& filename, const Grid& maze,
+                                               std::uint64_t contentHash, int clusterSize);
+
+    /// Write the graph with the content hash of the walls it was built for
+    bool save(const std::string& filename, std::uint64_t contentHash) const;
+
+    int clusterSize() const { return clusterSize_; }
+
+    /// Cluster holding maze cell c, and its bounds
+    int clusterOf(const Coordinates& c) const { return (c.second / clusterSize_) * clustersX_ + c.first / clusterSize_; }
+    ClusterBounds bounds(int cluster) const;
+
+    int nodeCount() const { return static_cast<int>(nodeCells_.size()); }
+    int nodeCell(int node) const { return nodeCells_[node]; }
+
+    /// Node on maze cell id, or -1
+    int nodeAt(int id) const;
+
+    /// Nodes inside a cluster
+    const int* clusterNodesBegin(int cluster) const { return clusterNodes_.data() + clusterStart_[cluster]; }
+    const int* clusterNodesEnd(int cluster) const { return clusterNodes_.data() + clusterStart_[cluster + 1]; }
+
+    /// Edges leaving node, as indices into edgeTarget()/edgeCost()
+    int edgesBegin(int node) const { return edgeStart_[node]; }
+    int edgesEnd(int node) const { return edgeStart_[node + 1]; }
+    int edgeTarget(int edge) const { return edgeTargets_[edge]; }
+    int edgeCost(int edge) const { return edgeCosts_[edge]; }
+
+    std::size_t memoryBytes() const;
+
+private:
+    AbstractGraph() : clusterSize_(0), clustersX_(0), clustersY_(0), width_(0), height_(0) {}
+
+    void addEntrances(const Grid& maze, std::vector<int>& from, std::vector<int>& to, std::vector<int>& costs);
+    void indexNodes(const Grid& maze);
+
+    int clusterSize_;
+    int clustersX_;
+    int clustersY_;
+    int width_;
+    int height_;
+    std::vector<int> nodeCells_;
+    std::vector<int> sortedCells_;      ///< Node cells in ascending order, for nodeAt()
+    std::vector<int> sortedNodes_;      ///< Node of each entry of sortedCells_
+    std::vector<int> clusterStart_;
+    std::vector<int> clusterNodes_;
+    std::vector<int> edgeStart_;
+    std::vector<int> edgeTargets_;
+    std::vector<int> edgeCosts_;
+};
+
+#endif // ABSTRACT_GRAPH_H
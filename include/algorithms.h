@@ -3,24 +3,126 @@
 
 #include <vector>
 #include <string>
-#include "types.h"
+#include "grid.h"
+#include "search_workspace.h"
 
-// Forward declarations
-struct UIState;
+// Receives progress notifications from the search engines. Engines know
+// nothing about the terminal and never modify the maze, so several can
+// search the same Grid at once; drawing, explored/path markers, pacing and
+// user input all live in the observer.
+class SearchObserver {
+public:
+    virtual ~SearchObserver() {}
 
-bool findPathBFS(Matrix& maze, const Coordinates& start, const Coordinates& end,
-                 std::vector<Coordinates>& path, int& openedNodes, double delay, UIState& state);
+    /// Called after every opened node (a Grid cell id). Returning false
+    /// aborts the search.
+    virtual bool onExpand(const Grid& maze, int cell, int openedNodes) = 0;
 
-bool findPathDFS(Matrix& maze, const Coordinates& start, const Coordinates& end,
-                 std::vector<Coordinates>& path, int& openedNodes, double delay, UIState& state);
+    /// Called once with the final path, start to end.
+    virtual void onPathFound(const Grid& maze, const std::vector<Coordinates>& path) = 0;
+};
 
-bool findPathRandomSearch(Matrix& maze, const Coordinates& start, const Coordinates& end,
-                         std::vector<Coordinates>& path, int& openedNodes, double delay, UIState& state);
+// Observer for headless runs: never interrupts the search and draws nothing.
+class NullSearchObserver : public SearchObserver {
+public:
+    bool onExpand(const Grid&, int, int) override { return true; }
+    void onPathFound(const Grid&, const std::vector<Coordinates>&) override {}
+};
 
-bool findPathGreedySearch(Matrix& maze, const Coordinates& start, const Coordinates& end,
-                         std::vector<Coordinates>& path, int& openedNodes, double delay, UIState& state);
+// Signature shared by all search engines
+typedef bool (*PathFinder)(const Grid& maze, const Coordinates& start, const Coordinates& end,
+                           std::vector<Coordinates>& path, int& openedNodes,
+                           SearchWorkspace& workspace, SearchObserver& observer);
 
-bool findPathAStar(Matrix& maze, const Coordinates& start, const Coordinates& end,
-                   std::vector<Coordinates>& path, int& openedNodes, double delay, UIState& state);
+// Precomputation an engine wants on each maze it searches. mazeFile is the
+// file the maze was read from, or empty, for engines that keep their
+// precomputed data next to it.
+typedef void (*MazePreparation)(Grid& maze, const std::string& mazeFile);
 
-#endif // ALGORITHMS_H 
\ No newline at end of file
+struct AlgorithmInfo {
+    std::string name;   ///< Name shown in the menus and reports
+    std::string key;    ///< Short name used on the command line
+    PathFinder run;
+    std::string baseline;   ///< Key of the engine this one is a variant of, if any
+    MazePreparation prepare;    ///< Run once on each maze when it is loaded (may be null)
+    bool shortestPaths;         ///< Every path found is a shortest one
+};
+
+/// All search engines, in menu order
+const std::vector<AlgorithmInfo>& availableAlgorithms();
+
+/// Index of the engine with the given key, or -1
+int findAlgorithm(const std::string& key);
+
+/// Run the engine's preparation step, if it has one, on a freshly loaded maze
+void prepareMaze(const AlgorithmInfo& algorithm, Grid& maze, const std::string& mazeFile = std::string());
+
+bool findPathBFS(const Grid& maze, const Coordinates& start, const Coordinates& end,
+                 std::vector<Coordinates>& path, int& openedNodes, SearchWorkspace& workspace, SearchObserver& observer);
+
+bool findPathDFS(const Grid& maze, const Coordinates& start, const Coordinates& end,
+                 std::vector<Coordinates>& path, int& openedNodes, SearchWorkspace& workspace, SearchObserver& observer);
+
+bool findPathRandomSearch(const Grid& maze, const Coordinates& start, const Coordinates& end,
+                         std::vector<Coordinates>& path, int& openedNodes, SearchWorkspace& workspace, SearchObserver& observer);
+
+bool findPathGreedySearch(const Grid& maze, const Coordinates& start, const Coordinates& end,
+                         std::vector<Coordinates>& path, int& openedNodes, SearchWorkspace& workspace, SearchObserver& observer);
+
+bool findPathAStar(const Grid& maze, const Coordinates& start, const Coordinates& end,
+                   std::vector<Coordinates>& path, int& openedNodes, SearchWorkspace& workspace, SearchObserver& observer);
+
+// Search from both ends at once and stop where the two searches meet; the
+// returned paths are as short as those of the one-directional engines.
+bool findPathBidirectionalBFS(const Grid& maze, const Coordinates& start, const Coordinates& end,
+                              std::vector<Coordinates>& path, int& openedNodes, SearchWorkspace& workspace, SearchObserver& observer);
+
+bool findPathBidirectionalAStar(const Grid& maze, const Coordinates& start, const Coordinates& end,
+                                std::vector<Coordinates>& path, int& openedNodes, SearchWorkspace& workspace, SearchObserver& observer);
+
+// Jump Point Search adapted to 4-connected grids: A* over the cells where
+// an optimal path may turn, jumping straight across everything in between.
+// The JPS+ variant reads the jumps from the maze's JumpTable, built when the
+// maze is loaded, and scans like plain JPS when the maze has none.
+bool findPathJPS(const Grid& maze, const Coordinates& start, const Coordinates& end,
+                 std::vector<Coordinates>& path, int& openedNodes, SearchWorkspace& workspace, SearchObserver& observer);
+
+bool findPathJPSPlus(const Grid& maze, const Coordinates& start, const Coordinates& end,
+                     std::vector<Coordinates>& path, int& openedNodes, SearchWorkspace& workspace, SearchObserver& observer);
+
+// Level-synchronous BFS on workerCount() threads. Each level is expanded
+// top-down from the frontier or, once the frontier is large, bottom-up
+// from the cells not reached yet. Paths are as short as findPathBFS's.
+// The observer sees a level's cells in one go once all are expanded.
+bool findPathParallelBFS(const Grid& maze, const Coordinates& start, const Coordinates& end,
+                         std::vector<Coordinates>& path, int& openedNodes, SearchWorkspace& workspace, SearchObserver& observer);
+
+// Hierarchical A* (HPA*) over the maze's AbstractGraph: A* between the
+// cluster entrances first, then BFS inside the clusters the chosen route
+// crosses. Paths are close to shortest but not always shortest. Mazes not
+// prepared for it get a graph built for the run.
+bool findPathHPAStar(const Grid& maze, const Coordinates& start, const Coordinates& end,
+                     std::vector<Coordinates>& path, int& openedNodes, SearchWorkspace& workspace, SearchObserver& observer);
+
+/// Side of the square clusters HPA* cuts mazes into
+/// (AbstractGraph::kDefaultClusterSize unless set)
+int hpaClusterSize();
+
+/// Use clusters size cells square for graphs built from here on; mazes
+/// already prepared keep theirs, so set it before loading any
+void setHpaClusterSize(int size);
+
+// A* over the maze's CorridorGraph: junction to junction, a whole corridor
+// per step, with corridors walked back out into cells at the end. Paths are
+// as short as A*'s. Falls back to findPathAStar when start or end lies in
+// a filled dead end, which only happens for cells not marked as the maze's
+// start or end.
+bool findPathCorridorAStar(const Grid& maze, const Coordinates& start, const Coordinates& end,
+                           std::vector<Coordinates>& path, int& openedNodes, SearchWorkspace& workspace, SearchObserver& observer);
+
+// D* Lite (see DStarLite) searching from the end. Paths are as short as
+// A*'s; a planner kept after the run repairs them after wall edits.
+bool findPathDStarLite(const Grid& maze, const Coordinates& start, const Coordinates& end,
+                       std::vector<Coordinates>& path, int& openedNodes, SearchWorkspace& workspace, SearchObserver& observer);
+
+#endif // ALGORITHMS_H
@@ -0,0 +1,51 @@
+#ifndef BATCH_SOLVER_H
+#define BATCH_SOLVER_H
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "algorithms.h"
+#include "grid.h"
+
+// Outcome of one headless solve
+struct SolveReport {
+    std::string maze;       ///< Maze file name
+    bool loaded;            ///< Whether the maze could be read
+    bool found;             ///< Whether a path was found
+    int width, height;      ///< Maze dimensions
+    std::vector<Coordinates> path;
+    int openedNodes;
+    long long pushes;       ///< Open-list insertions made by the engine
+    double loadMs;          ///< Time spent reading and preparing the maze
+    double solveMs;         ///< Time spent in the search engine
+    RunMemory memory;       ///< Memory held and allocated by the search
+};
+
+/// Load filename and run algorithm on it without any UI. When solved is
+/// given it receives the loaded maze, and start and end receive the
+/// endpoints.
+SolveReport solveMazeFile(const std::string& filename, const AlgorithmInfo& algorithm,
+                          SearchWorkspace& workspace, Grid* solved = nullptr,
+                          Coordinates* start = nullptr, Coordinates* end = nullptr);
+
+struct BatchOptions {
+    std::vector<std::string> mazes;
+    int algorithm;          ///< Index into availableAlgorithms()
+    int jobs;               ///< Solver threads
+    std::string outputDir;  ///< Where solved mazes are written (empty: none)
+};
+
+/// Maze files listed by a batch source: every .txt and .mzb file of a
+/// directory in natural order, or the lines of a manifest file (blank
+/// lines and '#' comments are skipped; relative paths are resolved
+/// against the manifest's directory). False if path cannot be read.
+bool collectBatchMazes(const std::string& path, std::vector<std::string>& mazes);
+
+/// Solve every maze as a load -> solve -> write pipeline. Loader and
+/// solver threads are started once and hand work over through bounded
+/// queues; a single writer prints one CSV row per maze to out, in input
+/// order, and writes solved mazes to outputDir. Returns the number of
+/// mazes that could not be loaded or written.
+int runBatch(const BatchOptions& options, std::FILE* out);
+
+#endif // BATCH_SOLVER_H
@@ -0,0 +1,50 @@
+#ifndef BINARY_MAZE_H
+#define BINARY_MAZE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include "grid.h"
+#include "wall_bitmap.h"
+
+// Binary maze file (.mzb): a fixed 64-byte little-endian header followed
+// by the wall bitmap, one bit per cell, rows padded to 64-bit words exactly
+// as in WallBitmap. The bitmap starts 64 bytes in, so a mapping of the file
+// can be used as uint64_t words without copying.
+const char kBinaryMazeMagic[4] = {'M', 'Z', 'B', '\0'};
+const std::uint32_t kBinaryMazeVersion = 1;
+
+struct BinaryMazeHeader {
+    char magic[4];              ///< kBinaryMazeMagic
+    std::uint32_t version;      ///< kBinaryMazeVersion
+    std::uint32_t width;
+    std::uint32_t height;
+    std::int32_t startX;
+    std::int32_t startY;
+    std::int32_t endX;
+    std::int32_t endY;
+    std::uint32_t wordsPerRow;
+    std::uint32_t reserved;
+    std::uint64_t contentHash;  ///< hashWalls() of the bitmap
+    std::uint64_t dataOffset;   ///< Byte offset of the bitmap
+    std::uint8_t padding[8];
+};
+
+static_assert(sizeof(BinaryMazeHeader) == 64, "BinaryMazeHeader must stay 64 bytes");
+
+/// 64-bit content hash of a wall bitmap
+std::uint64_t hashWalls(const std::uint64_t* words, std::size_t count);
+std::uint64_t hashWalls(const WallBitmap& walls);
+
+/// True if the buffer starts with a binary maze header
+bool isBinaryMaze(const char* data, std::size_t size);
+
+/// Build a Grid from a mapped binary maze; returns an empty Grid on error
+Grid parseBinaryMaze(const char* data, std::size_t size, const std::string& filename,
+                     Coordinates& start, Coordinates& end);
+
+/// Write walls and endpoints as a binary maze file
+bool writeBinaryMaze(const std::string& filename, const WallBitmap& walls,
+                     const Coordinates& start, const Coordinates& end);
+
+#endif // BINARY_MAZE_H
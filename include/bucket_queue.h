@@ -0,0 +1,150 @@
+#ifndef BUCKET_QUEUE_H
+#define BUCKET_QUEUE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+#include "memory_usage.h"
+
+// How a BucketQueue orders entries with the same key
+enum TieBreak {
+    TIES_FIFO,              ///< In the order they were pushed
+    TIES_LIFO,              ///< Most recently pushed first
+    TIES_LARGER_SECONDARY   ///< Largest secondary key first, e.g. g in A*
+};
+
+// Open list for small non-negative integer keys such as path costs or
+// grid distances: one bucket per key and a cursor at the smallest
+// non-empty bucket. FIFO and LIFO push and pop in O(1); the cursor only
+// moves as far as the keys do, which on a grid is a step or two per pop.
+// TIES_LARGER_SECONDARY sorts a bucket once when the cursor reaches it and
+// keeps it sorted by insertion while it is being popped.
+//
+// Buckets keep their storage across clear(), so one queue can be reused
+// for many searches. Storage is reported to the MemoryCounter given at
+// construction, if any.
+template <typename T>
+class BucketQueue {
+public:
+    explicit BucketQueue(TieBreak tieBreak = TIES_LIFO, MemoryCounter* counter = nullptr)
+        : tieBreak_(tieBreak), buckets_(CountingAllocator<Bucket>(counter)), heads_(CountingAllocator<std::size_t>(counter)),
+          sorted_(CountingAllocator<bool>(counter)), cursor_(0), size_(0), peakSize_(0) {}
+
+    bool empty() const { return size_ == 0; }
+    std::size_t size() const { return size_; }
+
+    /// Most entries held at once since the last clear()
+    std::size_t peakSize() const { return peakSize_; }
+
+    /// Change the tie-breaking rule; only valid while the queue is empty
+    void setTieBreak(TieBreak tieBreak) { tieBreak_ = tieBreak; }
+
+    /// Bytes reserved by the buckets
+    std::size_t memoryBytes() const {
+        std::size_t bytes = buckets_.capacity() * sizeof(Bucket) + heads_.capacity() * sizeof(std::size_t) +
+                            sorted_.capacity() / 8;
+        for (std::size_t key = 0; key < buckets_.size(); ++key) {
+            bytes += buckets_[key].capacity() * sizeof(Entry);
+        }
+        return bytes;
+    }
+
+    void clear() {
+        for (std::size_t key = cursor_; key < buckets_.size(); ++key) {
+            buckets_[key].clear();
+            heads_[key] = 0;
+            sorted_[key] = false;
+        }
+        cursor_ = 0;
+        size_ = 0;
+        peakSize_ = 0;
+    }
+
+    /// Add value under key (>= 0); secondary only matters for TIES_LARGER_SECONDARY
+    void push(int key, const T& value, int secondary = 0) {
+        if (key >= static_cast<int>(buckets_.size())) {
+            buckets_.resize(key + 1, Bucket(buckets_.get_allocator()));
+            heads_.resize(key + 1, 0);
+            sorted_.resize(key + 1, false);
+        }
+        Bucket& bucket = buckets_[key];
+        bucket.push_back(Entry{secondary, value});
+        if (tieBreak_ == TIES_LARGER_SECONDARY && sorted_[key]) {
+            // Only the bucket being popped is kept sorted, and the engines
+            // push deeper cells into it than the ones left there
+            std::size_t slot = bucket.size() - 1;
+            for (; slot > 0 && bucket[slot - 1].secondary > secondary; --slot) {
+                bucket[slot] = bucket[slot - 1];
+            }
+            bucket[slot] = Entry{secondary, value};
+        }
+        if (size_ == 0 || key < cursor_) {
+            cursor_ = key;
+        }
+        if (++size_ > peakSize_) {
+            peakSize_ = size_;
+        }
+    }
+
+    /// Smallest key in the queue, which must not be empty
+    int minKey() {
+        while (heads_[cursor_] == buckets_[cursor_].size()) {
+            sorted_[cursor_] = false;
+            ++cursor_;
+        }
+        if (tieBreak_ == TIES_LARGER_SECONDARY && !sorted_[cursor_]) {
+            Bucket& bucket = buckets_[cursor_];
+            std::stable_sort(bucket.begin(), bucket.end(), SmallerSecondary());
+            sorted_[cursor_] = true;
+        }
+        return cursor_;
+    }
+
+    /// Entry pop() would return next
+    const T& top() {
+        const Bucket& bucket = buckets_[minKey()];
+        if (tieBreak_ == TIES_FIFO) {
+            return bucket[heads_[cursor_]].value;
+        }
+        return bucket.back().value;
+    }
+
+    /// Remove and return an entry with the smallest key
+    T pop() {
+        Bucket& bucket = buckets_[minKey()];
+        --size_;
+        if (tieBreak_ == TIES_FIFO) {
+            T value = bucket[heads_[cursor_]++].value;
+            if (heads_[cursor_] == bucket.size()) {
+                bucket.clear();
+                heads_[cursor_] = 0;
+            }
+            return value;
+        }
+        T value = bucket.back().value;
+        bucket.pop_back();
+        return value;
+    }
+
+private:
+    struct Entry {
+        int secondary;
+        T value;
+    };
+
+    struct SmallerSecondary {
+        bool operator()(const Entry& a, const Entry& b) const { return a.secondary < b.secondary; }
+    };
+
+    typedef std::vector<Entry, CountingAllocator<Entry>> Bucket;
+
+    TieBreak tieBreak_;
+    std::vector<Bucket, CountingAllocator<Bucket>> buckets_;
+    std::vector<std::size_t, CountingAllocator<std::size_t>> heads_;   ///< Next entry to pop per bucket (FIFO only)
+    std::vector<bool, CountingAllocator<bool>> sorted_;   ///< Bucket is in secondary order (TIES_LARGER_SECONDARY only)
+    int cursor_;                        ///< No bucket below it holds entries
+    std::size_t size_;
+    std::size_t peakSize_;
+};
+
+#endif // BUCKET_QUEUE_H
@@ -0,0 +1,32 @@
+#ifndef COMMAND_LINE_H
+#define COMMAND_LINE_H
+
+// Non-interactive entry point, used whenever the program is started with
+// arguments. Never initialises the terminal UI.
+//
+//   --solve FILE [--algo KEY] [--no-path]
+//       Solve one maze and print path, stats and timing to stdout
+//   --solve FILE --queries STARTS
+//       Shortest path length from every "x,y" line of STARTS to the maze's
+//       end, answered from one cached distance field of the end
+//   --solve FILE --edits TOGGLES
+//       Toggle the wall on every "x,y" line of TOGGLES in turn, repairing
+//       the path with D* Lite after each, and compare with a fresh A*
+//   --solve FILE --pairs PAIRS [--algo KEY] [--jobs N]
+//       Solve every "x,y x,y" (start, end) line of PAIRS on one loaded
+//       maze, on N threads with reused workspaces; per-query and total
+//       timing
+//   --solve FILE --trace OUT.mzr [--algo KEY]
+//       Run the engine headless and save every cell it opened, and its
+//       path, as a compact trace; `maze_visualizer --replay OUT.mzr` plays
+//       it back in the terminal UI
+//   --solve FILE.mzt [--algo bfs|astar] [--cache-mb N] [--no-path]
+//       Solve a tiled maze, paging tiles and search state through caches
+//       of N megabytes each (default 256), for mazes larger than memory
+//   --batch DIR|MANIFEST [--algo KEY] [--jobs N] [--out DIR]
+//       Solve many mazes in parallel; one CSV row per maze on stdout
+//
+// Returns the process exit status.
+int runCommandLine(int argc, char** argv);
+
+#endif // COMMAND_LINE_H
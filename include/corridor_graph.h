@@ -0,0 +1,67 @@
+#ifndef CORRIDOR_GRAPH_H
+#define CORRIDOR_GRAPH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "grid.h"
+
+// The maze reduced to its junctions. Dead ends are filled first: a cell
+// with at most one open neighbour cannot lie on a path between two other
+// cells, so it is removed, which may turn its neighbour into a dead end in
+// turn. Start and end cells are never filled. What is left is junctions
+// (cells with other than two kept neighbours, plus start and end) joined
+// by one-cell corridors; each corridor becomes one weighted edge, stored
+// per junction in CSR form with the direction it leaves the junction in,
+// so a route can be walked back out cell by cell.
+class CorridorGraph {
+public:
+    explicit CorridorGraph(const Grid& maze);
+
+    /// Whether cell id survived dead-end filling
+    bool kept(int id) const { return (cells_[id] & kKeptCell) != 0; }
+
+    /// Directions (bit d) from cell id to kept neighbours
+    unsigned keptMask(int id) const { return cells_[id] & 15u; }
+
+    /// Whether cell id is a junction
+    bool isJunction(int id) const { return (cells_[id] & kJunctionCell) != 0; }
+
+    /// Junction on cell id, or -1
+    int junctionAt(int id) const;
+    int junctionCell(int junction) const { return junctionCells_[junction]; }
+    int junctionCount() const { return static_cast<int>(junctionCells_.size()); }
+
+    /// Corridors leaving a junction, as indices for the accessors below
+    int edgesBegin(int junction) const { return edgeStart_[junction]; }
+    int edgesEnd(int junction) const { return edgeStart_[junction + 1]; }
+    int edgeTarget(int edge) const { return edgeTargets_[edge]; }
+    int edgeCost(int edge) const { return edgeCosts_[edge]; }
+    int edgeDirection(int edge) const { return edgeDirections_[edge]; }
+
+    /// Follow the corridor leaving `from` in direction d up to the first
+    /// junction or `stop` cell; returns that cell and sets cost to the
+    /// moves taken. If the corridor loops back to `from`, returns `from`.
+    int walk(const Grid& maze, int from, int d, int stop, int& cost) const;
+
+    /// Open cells of the maze, and those removed by dead-end filling
+    int openCells() const { return openCells_; }
+    int filledCells() const { return filledCells_; }
+
+    std::size_t memoryBytes() const;
+
+private:
+    static const std::uint8_t kKeptCell = 16;
+    static const std::uint8_t kJunctionCell = 32;
+
+    std::vector<std::uint8_t> cells_;   ///< Kept-neighbour mask and flags, by cell id
+    std::vector<int> junctionCells_;    ///< Ascending
+    std::vector<int> edgeStart_;
+    std::vector<int> edgeTargets_;
+    std::vector<int> edgeCosts_;
+    std::vector<std::uint8_t> edgeDirections_;
+    int openCells_;
+    int filledCells_;
+};
+
+#endif // CORRIDOR_GRAPH_H
@@ -0,0 +1,29 @@
+#ifndef CURSES_OBSERVER_H
+#define CURSES_OBSERVER_H
+
+#include <chrono>
+#include "algorithms.h"
+#include "maze_renderer.h"
+#include "ui_state.h"
+
+// Live ncurses visualisation of a running search. Every step is paced by
+// the configured speed and polls pause, restart and quit keys, but the
+// screen is only repainted (changed cells and status) at most once per
+// frame interval, independent of the step rate.
+class CursesSearchObserver : public SearchObserver {
+public:
+    CursesSearchObserver(UIState& state, MazeRenderer& renderer);
+
+    bool onExpand(const Grid& maze, int cell, int openedNodes) override;
+    void onPathFound(const Grid& maze, const std::vector<Coordinates>& path) override;
+
+private:
+    bool pollControls();
+    void presentFrame();
+
+    UIState& state_;
+    MazeRenderer& renderer_;
+    std::chrono::steady_clock::time_point lastFrame_;
+};
+
+#endif // CURSES_OBSERVER_H
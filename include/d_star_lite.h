@@ -0,0 +1,69 @@
+#ifndef D_STAR_LITE_H
+#define D_STAR_LITE_H
+
+#include <cstddef>
+#include <vector>
+#include "bucket_queue.h"
+#include "grid.h"
+
+class SearchObserver;
+
+// D* Lite over a Grid whose walls change between searches. The search runs
+// backward from the end and keeps, per cell, g (its distance to the end as
+// last expanded) and rhs (the best neighbour's g plus one). A cell is
+// queued only while the two disagree, so after a wall is toggled just the
+// cells next to it are queued, and plan() expands those and the cells the
+// change spreads to: a repair costs time in the size of the affected
+// region, not of the maze. Start and end stay fixed, so the key modifier
+// of full D* Lite stays 0 and this is LPA* searching from the end.
+class DStarLite {
+public:
+    /// The per-cell arrays report to cellCounter and the open list to
+    /// frontierCounter, when given
+    DStarLite(const Grid& maze, int startId, int endId, MemoryCounter* cellCounter = nullptr,
+              MemoryCounter* frontierCounter = nullptr);
+
+    /// Expand inconsistent cells until the start's distance is settled.
+    /// Each expansion is counted in openedNodes and reported to observer;
+    /// returns false if the observer aborted, and a later call carries on.
+    bool plan(SearchObserver& observer, int& openedNodes);
+
+    /// Tell the planner that maze cell id turned into a wall or back
+    /// into a path cell; the Grid must already hold the change. Start and
+    /// end must stay open.
+    void cellChanged(int id);
+
+    /// Whether the last plan() found the end reachable from the start
+    bool pathExists() const;
+
+    /// Shortest path start..end from the last plan(); false, with path
+    /// cleared, when there is none
+    bool path(std::vector<Coordinates>& path) const;
+
+    /// Open-list insertions since construction
+    long long pushes() const { return pushes_; }
+
+    /// Most cells queued at once since construction
+    std::size_t peakOpen() const { return open_.peakSize(); }
+
+    std::size_t memoryBytes() const;
+
+private:
+    int heuristic(int id) const;
+    int lookahead(int id) const;
+    void updateCell(int id);
+
+    const Grid& maze_;
+    int startId_;
+    int endId_;
+    Coordinates start_;
+    typedef std::vector<int, CountingAllocator<int>> IntArray;
+
+    IntArray g_;                    ///< Indexed by Grid cell id
+    IntArray rhs_;
+    IntArray queuedKey_;            ///< Second key of a queued cell, or -1
+    BucketQueue<int> open_;         ///< Keyed by the first key, min(g, rhs) + h
+    long long pushes_;
+};
+
+#endif // D_STAR_LITE_H
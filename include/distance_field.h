@@ -0,0 +1,98 @@
+#ifndef DISTANCE_FIELD_H
+#define DISTANCE_FIELD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include "grid.h"
+
+// Distance from every cell to one goal cell, from a single BFS flood out of
+// the goal (moves are symmetric, so this is the reverse distance field). A
+// shortest path from any start is then a walk downhill: each step goes to
+// a neighbour one closer to the goal, so a query costs O(path length).
+class DistanceField {
+public:
+    DistanceField(const Grid& maze, int goalId);
+
+    int goal() const { return goalId_; }
+
+    /// Moves from cell id to the goal, or -1 when the goal cannot be reached
+    int distance(int id) const { return distances_[id]; }
+
+    /// Shortest path from startId to the goal, start first. False, with
+    /// path cleared, when the goal cannot be reached from startId.
+    bool path(const Grid& maze, int startId, std::vector<Coordinates>& path) const;
+
+    std::size_t memoryBytes() const { return distances_.capacity() * sizeof(int); }
+
+private:
+    int goalId_;
+    std::vector<int> distances_;    ///< Indexed by Grid cell id
+};
+
+// Distance fields keyed by maze and goal, kept within a memory budget and
+// evicted least recently used first. Mazes are named by the caller, e.g.
+// with distanceFieldKey(); a maze whose walls change under the same name
+// must be dropped with erase(). Fields are handed out as shared pointers,
+// so one evicted while a caller still walks it stays valid. Safe to use
+// from several threads.
+class DistanceFieldCache {
+public:
+    explicit DistanceFieldCache(std::size_t budgetBytes);
+
+    /// Field for goalId on maze, built on a miss. A field larger than the
+    /// whole budget is built and returned but not kept.
+    std::shared_ptr<const DistanceField> field(const std::string& mazeKey, const Grid& maze, int goalId);
+
+    /// Field for goalId on the maze if one is cached, else null; never floods
+    std::shared_ptr<const DistanceField> cached(const std::string& mazeKey, int goalId);
+
+    /// Shortest path from start to goal through the goal's cached field
+    bool findPath(const std::string& mazeKey, const Grid& maze, const Coordinates& start, const Coordinates& goal,
+                  std::vector<Coordinates>& path);
+
+    /// Drop every field of one maze
+    void erase(const std::string& mazeKey);
+    void clear();
+
+    std::size_t budgetBytes() const { return budgetBytes_; }
+    std::size_t memoryBytes() const;
+
+    long long hits() const;
+    long long misses() const;
+    long long evictions() const;
+
+private:
+    typedef std::pair<std::string, int> Key;
+    typedef std::pair<Key, std::shared_ptr<const DistanceField>> Entry;
+
+    void evictTo(std::size_t budgetBytes);
+
+    std::size_t budgetBytes_;
+    std::size_t usedBytes_;
+    std::list<Entry> entries_;  ///< Most recently used first
+    std::map<Key, std::list<Entry>::iterator> index_;
+    long long hits_;
+    long long misses_;
+    long long evictions_;
+    mutable std::mutex mutex_;
+};
+
+/// Name for a maze in a DistanceFieldCache from where it was read and the
+/// hashWalls() of its walls, so a maze edited or changed on disk gets a new
+/// name rather than the fields of its old walls
+std::string distanceFieldKey(const std::string& mazeName, std::uint64_t contentHash);
+
+/// Budget of the cache shared by the process
+const std::size_t kDefaultDistanceFieldBytes = std::size_t(256) << 20;
+
+/// Cache shared by the terminal UI's results screen and the command line
+DistanceFieldCache& sharedDistanceFieldCache();
+
+#endif // DISTANCE_FIELD_H
@@ -0,0 +1,124 @@
+#ifndef GRID_H
+#define GRID_H
+
+#include <vector>
+#include <climits>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "memory_usage.h"
+#include "types.h"
+#include "wall_bitmap.h"
+
+class AbstractGraph;
+class CorridorGraph;
+class JumpTable;
+
+// Values stored in a Grid cell
+enum CellKind : std::int8_t {
+    CELL_END = -2,
+    CELL_START = -1,
+    CELL_PATH = 0,
+    CELL_WALL = 1,
+    CELL_FINAL_PATH = 2,
+    CELL_EXPLORED = 3
+};
+
+// Maze representation as a contiguous row-major array of 1-byte cells.
+// The maze is surrounded by a one-cell wall border, so a neighbour of any
+// maze cell is always a valid index and engines need no bounds checks.
+// Cell ids are indices into the padded array.
+class Grid {
+public:
+    Grid();
+    /// width x height must satisfy fits()
+    Grid(int width, int height);
+
+    /// Whether a width x height maze, with its border, keeps every cell id
+    /// and count within int. Loaders check this before building a Grid.
+    static bool fits(long long width, long long height) {
+        return width > 0 && height > 0 && (width + 2) * (height + 2) <= INT_MAX;
+    }
+
+    int width() const { return width_; }
+    int height() const { return height_; }
+    int stride() const { return stride_; }
+    bool empty() const { return width_ == 0 || height_ == 0; }
+
+    /// Number of cells in the padded array, i.e. the upper bound of cell ids
+    int cellCount() const { return static_cast<int>(cells_.size()); }
+
+    int index(int x, int y) const { return (y + 1) * stride_ + (x + 1); }
+    int index(const Coordinates& c) const { return index(c.first, c.second); }
+    Coordinates coordinates(int id) const { return Coordinates(id % stride_ - 1, id / stride_ - 1); }
+
+    std::int8_t& operator[](int id) { return cells_[id]; }
+    std::int8_t operator[](int id) const { return cells_[id]; }
+    std::int8_t& at(int x, int y) { return cells_[index(x, y)]; }
+    std::int8_t at(int x, int y) const { return cells_[index(x, y)]; }
+
+    /// Id delta for moving in direction d (same order as `directions`)
+    int offset(int d) const { return offsets_[d]; }
+
+    /// Bit d is set when the neighbour in direction d is not a wall
+    std::uint8_t openMask(int id) const { return masks_[id]; }
+
+    /// Mark the walls of rows [firstRow, lastRow) from a bitmap; the rows
+    /// are expected to hold only path cells
+    void setWalls(const WallBitmap& walls, int firstRow, int lastRow);
+    void setWalls(const std::uint64_t* words, int wordsPerRow, int firstRow, int lastRow);
+
+    /// Wall bitmap of the maze; start and end cells count as open
+    WallBitmap walls() const;
+
+    /// Rebuild the open-neighbour masks; call after changing walls. The
+    /// row-range form is for loaders filling rows in parallel and leaves
+    /// the jump table alone.
+    void computeNeighbourMasks();
+    void computeNeighbourMasks(int firstRow, int lastRow);
+
+    /// Turn maze cell id into a wall or an open path cell, updating the
+    /// masks around it. Drops the derived data like computeNeighbourMasks().
+    void setWall(int id, bool wall);
+
+    /// Precompute the jump distances used by the JPS+ engine. They are
+    /// dropped again by computeNeighbourMasks().
+    void buildJumpTable();
+
+    /// Jump distances from buildJumpTable(), or null
+    const JumpTable* jumpTable() const { return jumpTable_.get(); }
+
+    /// Build the clusters and entrance graph used by the HPA* engine, with
+    /// clusters clusterSize cells square. With a cacheFile, a graph saved
+    /// there for the same walls and cluster size is read instead and a
+    /// newly built one is written there. Dropped again by
+    /// computeNeighbourMasks().
+    void buildAbstractGraph(const std::string& cacheFile, int clusterSize);
+
+    /// Graph from buildAbstractGraph(), or null
+    const AbstractGraph* abstractGraph() const { return abstractGraph_.get(); }
+
+    /// Fill dead ends and contract corridors for the corridor engine.
+    /// Dropped again by computeNeighbourMasks().
+    void buildCorridorGraph();
+
+    /// Junction graph from buildCorridorGraph(), or null
+    const CorridorGraph* corridorGraph() const { return corridorGraph_.get(); }
+
+    /// Bytes reserved by the cells, masks and derived data built so far,
+    /// counting each of them as one allocation
+    MemoryUsage memoryUsage() const;
+
+private:
+    int width_;
+    int height_;
+    int stride_;
+    int offsets_[4];
+    std::vector<std::int8_t> cells_;
+    std::vector<std::uint8_t> masks_;
+    std::shared_ptr<const JumpTable> jumpTable_;
+    std::shared_ptr<const AbstractGraph> abstractGraph_;
+    std::shared_ptr<const CorridorGraph> corridorGraph_;
+};
+
+#endif // GRID_H
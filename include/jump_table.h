@@ -0,0 +1,41 @@
+#ifndef JUMP_TABLE_H
+#define JUMP_TABLE_H
+
+#include <cstddef>
+#include <vector>
+#include "grid.h"
+
+// Jump Point Search on a 4-connected grid prunes moves as follows. A search
+// moving horizontally may continue or turn up or down at any cell; one
+// moving vertically only continues, unless a horizontal neighbour is forced
+// (see forcedNeighbours). A horizontal jump therefore stops at cells where a
+// vertical jump would find something, a vertical jump at forced cells.
+
+/// Horizontal directions (as direction bits) that become forced when a
+/// vertical move in direction d enters cell id: open beside id but walled
+/// beside the cell the move came from
+inline unsigned forcedNeighbours(const Grid& maze, int id, int d) {
+    return maze.openMask(id) & ~maze.openMask(id - maze.offset(d)) & 3u;
+}
+
+// JPS+ jump distances, precomputed per cell and direction for a fixed set
+// of walls. A positive distance n means a jump from the cell in that
+// direction stops at a jump point n cells away; zero or a negative -n means
+// it hits a wall after n open cells. Goal-dependent stops are left to the
+// engine.
+class JumpTable {
+public:
+    explicit JumpTable(const Grid& maze);
+
+    int distance(int id, int d) const { return distances_[static_cast<std::size_t>(id) * 4 + d]; }
+
+    std::size_t memoryBytes() const { return distances_.capacity() * sizeof(int); }
+
+private:
+    int& at(int id, int d) { return distances_[static_cast<std::size_t>(id) * 4 + d]; }
+    void scan(const Grid& maze, int id, int d);
+
+    std::vector<int> distances_;
+};
+
+#endif // JUMP_TABLE_H
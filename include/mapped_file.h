@@ -0,0 +1,31 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+// Read-only memory mapping of a whole file. The mapping is released when
+// the object is destroyed.
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    /// Map `filename`; returns false if it cannot be opened or mapped
+    bool open(const std::string& filename);
+    void close();
+
+    bool isOpen() const { return fd_ >= 0; }
+    const char* data() const { return data_; }
+    std::size_t size() const { return size_; }
+
+private:
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+
+    int fd_;
+    const char* data_;
+    std::size_t size_;
+};
+
+#endif // MAPPED_FILE_H
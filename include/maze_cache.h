@@ -0,0 +1,94 @@
+#ifndef MAZE_CACHE_H
+#define MAZE_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "algorithms.h"
+#include "grid.h"
+
+// A maze as read from its file, with the precomputed data of the engines
+// it was prepared for. Never changed once cached: callers that edit walls
+// or mark cells work on a copy, which copies the cells and masks but
+// shares the precomputed data.
+struct CachedMaze {
+    Grid maze;
+    Coordinates start, end;
+    std::uint64_t contentHash;              ///< hashWalls() of maze's walls, e.g. for distanceFieldKey()
+    std::vector<MazePreparation> prepared;  ///< Preparations already run on maze
+};
+
+// Parsed mazes keyed by file name, so running another engine on a maze or
+// restarting one does not read and parse the file again. An entry is
+// reread when the file's modification time or size changes. Entries are
+// kept within a memory budget and evicted least recently used first, and
+// are handed out as shared pointers, so one evicted while a caller still
+// copies from it stays valid. Safe to use from several threads.
+class MazeCache {
+public:
+    explicit MazeCache(std::size_t budgetBytes);
+
+    /// Maze in filename, prepared for algorithm when given; null when the
+    /// file cannot be read. A maze larger than the whole budget is loaded
+    /// and returned but not kept.
+    std::shared_ptr<const CachedMaze> load(const std::string& filename, const AlgorithmInfo* algorithm = nullptr);
+
+    /// Maze in filename prepared for all of algorithms at once, so engines
+    /// that run side by side can share one copy
+    std::shared_ptr<const CachedMaze> load(const std::string& filename,
+                                           const std::vector<const AlgorithmInfo*>& algorithms);
+
+    void erase(const std::string& filename);
+    void clear();
+
+    std::size_t budgetBytes() const { return budgetBytes_; }
+    std::size_t memoryBytes() const;
+
+    long long hits() const;
+    long long misses() const;
+    long long evictions() const;
+
+private:
+    /// What identifies the contents of a file without reading it
+    struct FileStamp {
+        std::int64_t modifiedNs;
+        std::int64_t size;
+        bool operator==(const FileStamp& other) const {
+            return modifiedNs == other.modifiedNs && size == other.size;
+        }
+    };
+
+    struct Entry {
+        std::string filename;
+        FileStamp stamp;
+        std::shared_ptr<const CachedMaze> maze;
+        std::size_t bytes;
+    };
+
+    static bool stampOf(const std::string& filename, FileStamp& stamp);
+    void insert(const Entry& entry);
+    void eraseLocked(const std::string& filename);
+    void evictTo(std::size_t budgetBytes);
+
+    std::size_t budgetBytes_;
+    std::size_t usedBytes_;
+    std::list<Entry> entries_;  ///< Most recently used first
+    std::map<std::string, std::list<Entry>::iterator> index_;
+    long long hits_;
+    long long misses_;
+    long long evictions_;
+    mutable std::mutex mutex_;
+};
+
+/// Budget of the cache shared by the terminal UI
+const std::size_t kDefaultMazeCacheBytes = std::size_t(512) << 20;
+
+/// Cache shared by the terminal UI's runs and races
+MazeCache& sharedMazeCache();
+
+#endif // MAZE_CACHE_H
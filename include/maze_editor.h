@@ -0,0 +1,18 @@
+#ifndef MAZE_EDITOR_H
+#define MAZE_EDITOR_H
+
+#include <vector>
+#include "grid.h"
+#include "maze_renderer.h"
+#include "ui_state.h"
+
+// Wall editing on the maze of a finished run. Arrow keys move a cursor and
+// Space toggles the wall under it; after each toggle a D* Lite planner kept
+// for the whole session repairs the shortest path, and the cells the
+// repair expanded are shown as explored. E or Q leaves. Edits change maze
+// in place, so they last until the maze is loaded again. Returns whether a
+// path exists, with path and openedNodes from the last repair.
+bool editMaze(Grid& maze, const Coordinates& start, const Coordinates& end, MazeRenderer& renderer,
+              UIState& uiState, std::vector<Coordinates>& path, int& openedNodes);
+
+#endif // MAZE_EDITOR_H
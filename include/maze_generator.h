@@ -0,0 +1,57 @@
+#ifndef MAZE_GENERATOR_H
+#define MAZE_GENERATOR_H
+
+#include <cstdint>
+#include <string>
+#include "grid.h"
+#include "tiled_maze.h"
+#include "wall_bitmap.h"
+
+// Maze generation styles. The room styles carve a perfect maze (exactly
+// one path between any two cells) over rooms on odd coordinates, with the
+// cells between two rooms as the walls that can be removed; the cave style
+// smooths random noise with a cellular automaton into open caverns.
+enum MazeStyle {
+    STYLE_BACKTRACKER,  ///< Randomised depth-first search: long, winding corridors
+    STYLE_KRUSKAL,      ///< Random spanning tree from shuffled walls: many short dead ends
+    STYLE_PRIM,         ///< Randomised Prim: grows from one room, short branchy corridors
+    STYLE_WILSON,       ///< Loop-erased random walks: an unbiased uniform spanning tree
+    STYLE_CAVE,         ///< Open caverns and rooms
+    STYLE_ELLER         ///< Eller's algorithm, a row at a time: the style that streams
+};
+
+struct GeneratorOptions {
+    MazeStyle style = STYLE_BACKTRACKER;
+    int width = 101;
+    int height = 101;
+    std::uint64_t seed = 1;
+    double loopDensity = 0.0;   ///< Room styles: share of the walls between rooms removed afterwards
+    double wallDensity = 0.45;  ///< Cave style: share of cells seeded as walls before smoothing
+};
+
+/// Style with the given name ("backtracker", "kruskal", "prim", "wilson",
+/// "cave" or "eller"); false when there is none
+bool parseMazeStyle(const std::string& name, MazeStyle& style);
+const char* mazeStyleName(MazeStyle style);
+
+/// Read "STYLE:WIDTHxHEIGHT[:SEED]" into options, leaving the densities
+/// alone; false when malformed
+bool parseGeneratorSpec(const std::string& spec, GeneratorOptions& options);
+
+/// Generate the walls of a maze and its endpoints. The same options always
+/// give the same maze, on any platform. Room styles run from the top-left
+/// room to the bottom-right one, and even widths or heights leave the last
+/// column or row as wall. Returns an empty bitmap when the size is below
+/// 3x3 or too large for a Grid.
+WallBitmap generateMaze(const GeneratorOptions& options, Coordinates& start, Coordinates& end);
+
+/// generateMaze() straight into a Grid ready to search, without a file
+Grid generateGrid(const GeneratorOptions& options, Coordinates& start, Coordinates& end);
+
+/// Generate a maze straight into a tiled maze file (.mzt). STYLE_ELLER is
+/// streamed a band of tiles at a time, so memory stays at a band of rows
+/// and the maze may exceed both memory and the Grid size limit; the
+/// other styles are generated in memory first.
+bool generateTiledMaze(const std::string& filename, const GeneratorOptions& options, int tileSize);
+
+#endif // MAZE_GENERATOR_H
@@ -1,9 +1,22 @@
 #ifndef MAZE_LOADER_H
 #define MAZE_LOADER_H
 
-#include "types.h"
+#include "grid.h"
 #include <string>
+#include <vector>
 
-Matrix readMaze(const std::string& filename, Coordinates& start, Coordinates& end);
+// Load a maze in the text format or the binary .mzb format (detected from
+// the file contents)
+Grid readMaze(const std::string& filename, Coordinates& start, Coordinates& end);
+
+// Write a maze in the text format read by readMaze
+bool writeTextMaze(const std::string& filename, const WallBitmap& walls,
+                   const Coordinates& start, const Coordinates& end);
+
+// Write a solved maze in the text format: path is drawn with '*' and the
+// endpoints with 'S' and 'E'. readMaze treats those as open cells, so the
+// file still loads as the same maze.
+bool writeSolvedMaze(const std::string& filename, const Grid& maze, const std::vector<Coordinates>& path,
+                     const Coordinates& start, const Coordinates& end);
 
 #endif // MAZE_LOADER_H 
\ No newline at end of file
@@ -0,0 +1,87 @@
+#ifndef MAZE_RENDERER_H
+#define MAZE_RENDERER_H
+
+#include <cstdint>
+#include <vector>
+#include "grid.h"
+#include "ui_functions.h"
+#include "ui_state.h"
+
+// Incremental maze drawing. Search markers (explored and path cells) live
+// in an overlay owned by the renderer, never in the Grid, so several
+// renderers can show different searches over one shared maze. Marked
+// cells are queued and only the visible ones are repainted on the next
+// frame; the whole view is only repainted after it moves or the terminal
+// is resized. Mazes larger than their area also get a minimap whose
+// blocks aggregate explored cell counts, kept up to date as cells are
+// marked, so every frame costs time proportional to the screen area.
+class MazeRenderer {
+public:
+    /// Renderer drawing maze into the whole maze area of the screen
+    explicit MazeRenderer(const Grid& maze);
+
+    /// Draw into area instead (takes effect on the next redrawAll)
+    void setArea(const ScreenArea& area) { area_ = area; hasArea_ = true; }
+
+    /// Overlay a search marker (CELL_EXPLORED or CELL_FINAL_PATH) on a
+    /// cell, or remove it with CELL_PATH; start and end keep their own
+    /// glyphs
+    void mark(int cell, int kind);
+
+    /// Remove every marker (repaints the whole view on the next flush)
+    void clearMarks();
+
+    /// Repaint a cell whose wall was toggled in the maze
+    void wallChanged(int cell);
+
+    /// Recount and repaint everything after the maze's walls were replaced
+    /// as a whole, e.g. restored from a pristine copy; the maze must keep
+    /// its size
+    void wallsReplaced() { openCells_.clear(); viewDirty_ = true; }
+
+    /// Highlight one cell, e.g. the maze editor's cursor; -1 for none
+    void setCursor(int cell);
+
+    /// Cell kind as drawn: the overlay marker if any, else the maze cell
+    int cellKind(int cell) const { return marks_[cell] != CELL_PATH ? marks_[cell] : maze_[cell]; }
+
+    bool hasPending() const { return !dirty_.empty() || viewDirty_; }
+
+    /// Recenter the view on cell when following the frontier and the cell
+    /// has drifted close to the edge of the view
+    void follow(UIState& state, int cell);
+
+    /// Repaint the whole view on the next flush
+    void invalidateView() { viewDirty_ = true; }
+
+    /// Repaint the queued cells (or the whole view) and the minimap
+    void flush(UIState& state);
+
+    /// Lay the maze out for the current terminal size and repaint everything
+    void redrawAll(UIState& state);
+
+private:
+    void countBlocks();
+    void paintView(const UIState& state);
+    void drawCell(int screen_y, int screen_x, int cell);
+    void drawMinimap(const UIState& state);
+    int blockOf(int cell) const;
+
+    const Grid& maze_;
+    std::vector<std::int8_t> marks_;
+    ScreenArea area_;
+    bool hasArea_;
+    MazeLayout layout_;
+    std::vector<int> dirty_;
+    bool viewDirty_;
+    int cursor_;
+
+    // Per minimap block, row-major
+    std::vector<int> openCells_;
+    std::vector<int> exploredCells_;
+    std::vector<int> pathCells_;
+    int startBlock_;
+    int endBlock_;
+};
+
+#endif // MAZE_RENDERER_H
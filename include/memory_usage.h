@@ -0,0 +1,127 @@
+#ifndef MEMORY_USAGE_H
+#define MEMORY_USAGE_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+// Bytes and allocations of one kind of storage over a run
+struct MemoryUsage {
+    std::size_t bytes = 0;      ///< Held when the run ended
+    std::size_t peakBytes = 0;  ///< Most held at once during the run
+    long long allocations = 0;  ///< Allocations made during the run
+
+    MemoryUsage& operator+=(const MemoryUsage& other) {
+        bytes += other.bytes;
+        peakBytes += other.peakBytes;
+        allocations += other.allocations;
+        return *this;
+    }
+};
+
+// Running totals fed by CountingAllocator. Updates are atomic, so the
+// per-thread buffers of a parallel engine can share one counter.
+class MemoryCounter {
+public:
+    MemoryCounter() : bytes_(0), peakBytes_(0), allocations_(0) {}
+
+    void allocated(std::size_t bytes) {
+        std::size_t held = bytes_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        std::size_t peak = peakBytes_.load(std::memory_order_relaxed);
+        while (held > peak && !peakBytes_.compare_exchange_weak(peak, held, std::memory_order_relaxed)) {
+        }
+        allocations_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void released(std::size_t bytes) { bytes_.fetch_sub(bytes, std::memory_order_relaxed); }
+
+    /// Count allocations and the peak from here on; storage already held
+    /// stays counted
+    void startRun() {
+        peakBytes_.store(bytes_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        allocations_.store(0, std::memory_order_relaxed);
+    }
+
+    MemoryUsage usage() const {
+        MemoryUsage usage;
+        usage.bytes = bytes_.load(std::memory_order_relaxed);
+        usage.peakBytes = peakBytes_.load(std::memory_order_relaxed);
+        usage.allocations = allocations_.load(std::memory_order_relaxed);
+        return usage;
+    }
+
+private:
+    MemoryCounter(const MemoryCounter&);
+    MemoryCounter& operator=(const MemoryCounter&);
+
+    std::atomic<std::size_t> bytes_;
+    std::atomic<std::size_t> peakBytes_;
+    std::atomic<long long> allocations_;
+};
+
+// std::allocator that reports to a MemoryCounter. A default-constructed
+// one counts nothing, so containers that share a type with counted ones
+// cost nothing extra. The counter follows the container on copy, move and
+// swap, and must outlive it.
+template <typename T>
+class CountingAllocator {
+public:
+    typedef T value_type;
+    typedef std::true_type propagate_on_container_copy_assignment;
+    typedef std::true_type propagate_on_container_move_assignment;
+    typedef std::true_type propagate_on_container_swap;
+
+    CountingAllocator() : counter_(nullptr) {}
+    explicit CountingAllocator(MemoryCounter* counter) : counter_(counter) {}
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>& other) : counter_(other.counter()) {}
+
+    T* allocate(std::size_t count) {
+        T* storage = std::allocator<T>().allocate(count);
+        if (counter_ != nullptr) {
+            counter_->allocated(count * sizeof(T));
+        }
+        return storage;
+    }
+
+    void deallocate(T* storage, std::size_t count) {
+        if (counter_ != nullptr) {
+            counter_->released(count * sizeof(T));
+        }
+        std::allocator<T>().deallocate(storage, count);
+    }
+
+    MemoryCounter* counter() const { return counter_; }
+
+private:
+    MemoryCounter* counter_;
+};
+
+template <typename T, typename U>
+bool operator==(const CountingAllocator<T>& a, const CountingAllocator<U>& b) {
+    return a.counter() == b.counter();
+}
+
+template <typename T, typename U>
+bool operator!=(const CountingAllocator<T>& a, const CountingAllocator<U>& b) {
+    return a.counter() != b.counter();
+}
+
+// Memory of one search run by what holds it. The parent store and the
+// frontier are counted allocation by allocation through the workspace;
+// the path and the maze are allocated outside it, so for them bytes is
+// their capacity and allocations the buffers they hold.
+struct RunMemory {
+    MemoryUsage parents;            ///< Visited stamps, parent directions, costs
+    MemoryUsage frontier;           ///< Open lists and frontier buffers
+    MemoryUsage path;
+    MemoryUsage maze;               ///< Cells, masks and precomputed search data
+    std::size_t peakFrontier = 0;   ///< Most cells waiting in the open lists at once
+};
+
+/// "512 B", "3.4 KB", "12.0 MB", ...
+std::string formatBytes(std::size_t bytes);
+
+#endif // MEMORY_USAGE_H
@@ -10,6 +10,7 @@ bool showMainMenu(UIState& uiState, bool& programRunning);
 void showFileSelection(UIState& uiState);
 void showAlgorithmSelection(UIState& uiState);
 void showSpeedSelection(UIState& uiState);
+bool showRaceSelection(UIState& uiState);
 void drawButton(int y, int x, const std::string& text, bool selected);
 
 #endif // MENU_MANAGER_H 
\ No newline at end of file
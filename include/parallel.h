@@ -0,0 +1,68 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// Number of worker threads to use for data-parallel loops
+int workerCount();
+
+/// Cap data-parallel loops at count threads for the whole process (0
+/// restores the hardware default)
+void setWorkerCount(int count);
+
+// Caps the data-parallel loops the calling thread starts at count threads
+// while in scope (0 keeps its current cap), then restores the thread's
+// previous cap; other threads and the process-wide count are left alone.
+// Threads that already run one task per core hold a cap of 1 so nested
+// loops do not oversubscribe the machine.
+class ThreadWorkerLimit {
+public:
+    explicit ThreadWorkerLimit(int count);
+    ~ThreadWorkerLimit();
+
+private:
+    ThreadWorkerLimit(const ThreadWorkerLimit&);
+    ThreadWorkerLimit& operator=(const ThreadWorkerLimit&);
+
+    int previous_;
+};
+
+/// Split [0, count) into contiguous ranges of at least minChunk items and
+/// call fn(first, last) for each range on its own thread. Small inputs run
+/// inline on the calling thread.
+void parallelForRanges(int count, int minChunk, const std::function<void(int, int)>& fn);
+
+// Threads kept for the length of one parallel algorithm, for steps too
+// short to start threads for each time (e.g. the levels of a BFS). run()
+// calls fn(thread) on every team thread, the caller being thread 0, and
+// returns once all of them returned; the other threads sleep in between.
+class WorkerTeam {
+public:
+    explicit WorkerTeam(int threads);
+    ~WorkerTeam();
+
+    int size() const { return static_cast<int>(threads_.size()) + 1; }
+
+    void run(const std::function<void(int)>& fn);
+
+private:
+    WorkerTeam(const WorkerTeam&);
+    WorkerTeam& operator=(const WorkerTeam&);
+
+    void work(int thread);
+
+    std::vector<std::thread> threads_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    const std::function<void(int)>* task_;
+    unsigned long generation_;
+    int pending_;   ///< Team threads still inside the current task
+    bool stopping_;
+};
+
+#endif // PARALLEL_H
@@ -0,0 +1,77 @@
+#ifndef QUERY_SOLVER_H
+#define QUERY_SOLVER_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+#include "algorithms.h"
+#include "distance_field.h"
+#include "grid.h"
+#include "parallel.h"
+
+// One (start, end) pair to solve
+struct PathQuery {
+    Coordinates start;
+    Coordinates end;
+};
+
+struct QueryResult {
+    bool found;
+    std::size_t pathLength;
+    int openedNodes;
+    bool fromField;             ///< Read off the end's distance field
+    double solveMs;
+    std::vector<Coordinates> path;  ///< Only filled when paths are kept
+};
+
+// Totals over one batch of queries
+struct QueryBatchStats {
+    std::size_t queries;
+    std::size_t found;
+    std::size_t fieldQueries;   ///< Answered from a distance field rather than searched
+    int threads;
+    double elapsedMs;           ///< Wall time of the whole batch
+    double solveMs;             ///< Sum of the per-query solve times
+    double queriesPerSecond;
+};
+
+// Many queries against one loaded maze. The solver keeps a WorkerTeam and
+// one SearchWorkspace per team thread for its whole life, so a batch
+// neither reloads the maze nor allocates search state once the workspaces
+// have grown to the maze: the workspaces' epoch-stamped visited sets start
+// every query without clearing anything. Threads take queries a few at a
+// time from a shared counter, so uneven queries balance out. The maze
+// must already be prepared for the engine (see prepareMaze()).
+class QuerySolver {
+public:
+    QuerySolver(const Grid& maze, const AlgorithmInfo& algorithm, int threads);
+
+    int threads() const { return team_.size(); }
+
+    /// Answer queries to an end shared by several of them from the end's
+    /// distance field in cache, under mazeKey, instead of searching. Only
+    /// for engines whose paths are shortest anyway; such queries report no
+    /// opened nodes.
+    void useDistanceFields(DistanceFieldCache* cache, const std::string& mazeKey);
+
+    /// Solve every query into results (resized to match, in query order).
+    /// Queries whose start or end is a wall or outside the maze are
+    /// reported as not found without searching.
+    QueryBatchStats solve(const std::vector<PathQuery>& queries, std::vector<QueryResult>& results,
+                          bool keepPaths = false);
+
+    /// Bytes reserved by the per-thread workspaces
+    std::size_t memoryBytes() const;
+
+private:
+    const Grid& maze_;
+    const AlgorithmInfo& algorithm_;
+    DistanceFieldCache* fields_;
+    std::string mazeKey_;
+    WorkerTeam team_;
+    std::vector<std::unique_ptr<SearchWorkspace>> workspaces_;
+    std::vector<std::vector<Coordinates>> paths_;   ///< Per-thread path when paths are not kept
+};
+
+#endif // QUERY_SOLVER_H
@@ -0,0 +1,12 @@
+#ifndef RACE_MANAGER_H
+#define RACE_MANAGER_H
+
+#include "ui_state.h"
+
+// Race mode: every engine selected in uiState.race_selection searches the
+// current maze at the same time on its own thread. The maze is loaded once
+// and shared read-only; each engine draws into its own pane, and the
+// results are shown side by side once all have finished.
+void runRace(UIState& uiState);
+
+#endif // RACE_MANAGER_H
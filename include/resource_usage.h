@@ -0,0 +1,12 @@
+#ifndef RESOURCE_USAGE_H
+#define RESOURCE_USAGE_H
+
+/// Reset the process peak-RSS high-water mark where the OS allows it
+/// (Linux /proc/self/clear_refs). Returns false if it could not be reset,
+/// in which case peakRssKb() stays a whole-process maximum.
+bool resetPeakRss();
+
+/// Peak resident set size in KiB since start or the last successful reset
+long peakRssKb();
+
+#endif // RESOURCE_USAGE_H
@@ -2,10 +2,25 @@
 #define RESULTS_MANAGER_H
 
 #include "ui_state.h"
-#include "types.h"
+#include "grid.h"
+#include "maze_renderer.h"
+#include <string>
 #include <vector>
 
-// Results management functions
-bool showFinalResults(const Matrix& maze, bool pathFound, const std::vector<Coordinates>& path, int openedNodes, UIState& uiState);
+// Headless rerun of a variant engine and of the engine it refines, so the
+// results screen can show what the variant saved
+struct BaselineComparison {
+    std::string baseline;       ///< Name of the baseline engine
+    int openedNodes;
+    int baselineOpenedNodes;
+    double solveMs;
+    double baselineSolveMs;
+};
+
+// Results management functions; comparison and memory may be null, and
+// shortestLength is the length of a shortest path in nodes, or -1
+bool showFinalResults(MazeRenderer& renderer, bool pathFound, const std::vector<Coordinates>& path, int openedNodes, UIState& uiState,
+                      const BaselineComparison* comparison = nullptr, const RunMemory* memory = nullptr,
+                      int shortestLength = -1);
 
 #endif // RESULTS_MANAGER_H 
\ No newline at end of file
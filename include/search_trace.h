@@ -0,0 +1,82 @@
+#ifndef SEARCH_TRACE_H
+#define SEARCH_TRACE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "algorithms.h"
+#include "grid.h"
+
+// Everything a search showed its observer: the cells it opened, in order,
+// and the path it found. Cell ids are Grid ids of a maze with the recorded
+// width and walls. Recording one costs a push_back per opened cell, so the
+// search runs at full speed; playing it back (see playTrace()) never runs
+// the search again.
+struct SearchTrace {
+    std::string algorithm;          ///< Key of the engine that ran
+    std::string mazeFile;           ///< File the maze was read from
+    int width, height;
+    Coordinates start, end;
+    std::uint64_t contentHash;      ///< hashWalls() of the maze's walls()
+    bool found;
+    std::vector<int> expanded;      ///< Opened cells, in the order they were opened
+    std::vector<int> path;          ///< Path cells, start first
+
+    SearchTrace() : width(0), height(0), contentHash(0), found(false) {}
+};
+
+// Observer that records a search into a trace instead of drawing it
+class TraceRecorder : public SearchObserver {
+public:
+    explicit TraceRecorder(SearchTrace& trace) : trace_(trace) {}
+
+    bool onExpand(const Grid& maze, int cell, int openedNodes) override;
+    void onPathFound(const Grid& maze, const std::vector<Coordinates>& path) override;
+
+private:
+    SearchTrace& trace_;
+};
+
+/// Run algorithm on maze with a TraceRecorder and return the trace
+SearchTrace recordSearch(const AlgorithmInfo& algorithm, const Grid& maze, const std::string& mazeFile,
+                         const Coordinates& start, const Coordinates& end, SearchWorkspace& workspace);
+
+/// Whether trace was recorded on a maze with the walls of maze
+bool traceMatches(const SearchTrace& trace, const Grid& maze);
+
+// Trace file (.mzr): a fixed 64-byte little-endian header, the engine key
+// and the maze file name, then every opened cell and path cell in order as
+// the difference from the previous cell id, zigzag-encoded as a varint.
+// Consecutive cells are usually neighbours, so most take one or two bytes.
+const char kTraceMagic[4] = {'M', 'Z', 'R', '\0'};
+const std::uint32_t kTraceVersion = 1;
+
+struct TraceHeader {
+    char magic[4];              ///< kTraceMagic
+    std::uint32_t version;      ///< kTraceVersion
+    std::uint32_t width;
+    std::uint32_t height;
+    std::int32_t startX;
+    std::int32_t startY;
+    std::int32_t endX;
+    std::int32_t endY;
+    std::uint64_t contentHash;
+    std::uint64_t expandedCount;
+    std::uint32_t pathCount;
+    std::uint16_t algorithmBytes;   ///< Length of the engine key after the header
+    std::uint16_t mazeFileBytes;    ///< Length of the maze file name after the key
+    std::uint32_t found;
+    std::uint32_t reserved;
+};
+
+static_assert(sizeof(TraceHeader) == 64, "TraceHeader must stay 64 bytes");
+
+/// Write trace to filename; false, with a message on stderr, on failure
+bool writeTrace(const std::string& filename, const SearchTrace& trace);
+
+/// Read a trace written by writeTrace(); false, with a message on stderr,
+/// when the file cannot be read or is not a valid trace
+bool readTrace(const std::string& filename, SearchTrace& trace);
+
+#endif // SEARCH_TRACE_H
@@ -0,0 +1,147 @@
+#ifndef SEARCH_WORKSPACE_H
+#define SEARCH_WORKSPACE_H
+
+#include <vector>
+#include <cstdint>
+#include <memory>
+#include "bucket_queue.h"
+#include "grid.h"
+#include "memory_usage.h"
+
+
+// Per-cell bookkeeping shared by the search engines, indexed by Grid cell
+// id. Parents are stored as the 2-bit direction of the move that reached a
+// cell. A cell is visited when its stamp equals the current epoch, so
+// reset() starts a new run by bumping the epoch instead of clearing
+// anything; keep one workspace around and pass it to every run.
+class SearchWorkspace {
+public:
+    /// Cell list for frontiers an engine keeps outside the open list
+    typedef std::vector<int, CountingAllocator<int>> CellList;
+
+    SearchWorkspace();
+    ~SearchWorkspace();
+
+    /// Size the arrays for `maze` and start a new epoch, which empties the
+    /// visited set. Engines that track path costs pass withCosts to get
+    /// the g-cost array as well; engines that move several cells at once
+    /// pass withJumpParents.
+    void reset(const Grid& maze, bool withCosts = false, bool withJumpParents = false);
+
+    bool visited(int id) const { return stamps_[id] == epoch_; }
+    void markVisited(int id) { stamps_[id] = epoch_; }
+
+    /// Record that `id` was reached by moving in direction d from its parent
+    void setParent(int id, int d) {
+        int shift = (id & 3) * 2;
+        parents_[id >> 2] = static_cast<std::uint8_t>((parents_[id >> 2] & ~(3u << shift)) | (d << shift));
+    }
+    int parentDirection(int id) const { return (parents_[id >> 2] >> ((id & 3) * 2)) & 3; }
+
+    /// markVisited() and setParent() for engines that reach cells from
+    /// several threads at once. The stamp is claimed atomically, and so is
+    /// the parent byte neighbouring cells share; returns false, leaving the
+    /// parent alone, when id was already visited.
+    bool claimVisited(int id, int d) {
+        std::uint16_t* stamp = &stamps_[id];
+        if (__atomic_load_n(stamp, __ATOMIC_RELAXED) == epoch_ ||
+            __atomic_exchange_n(stamp, epoch_, __ATOMIC_RELAXED) == epoch_) {
+            return false;
+        }
+        int shift = (id & 3) * 2;
+        std::uint8_t* parent = &parents_[id >> 2];
+        __atomic_fetch_and(parent, static_cast<std::uint8_t>(~(3u << shift)), __ATOMIC_RELAXED);
+        __atomic_fetch_or(parent, static_cast<std::uint8_t>(d << shift), __ATOMIC_RELAXED);
+        return true;
+    }
+
+    /// visited() that may run while other threads call claimVisited()
+    bool claimed(int id) const {
+        return __atomic_load_n(&stamps_[id], __ATOMIC_RELAXED) == epoch_;
+    }
+
+    /// Path cost of a visited cell (only meaningful after it was assigned)
+    int& cost(int id) { return costs_[id]; }
+
+    /// Cell a straight multi-cell move to `id` started from; setParent()
+    /// holds the direction of that move
+    int& jumpParent(int id) { return jumpParents_[id]; }
+
+    /// Count insertions into the engine's open list (queue, stack or heap)
+    void countPush(long long count = 1) { pushes_ += count; }
+
+    /// Open-list insertions since the last reset
+    long long pushes() const { return pushes_; }
+
+    /// Follow parent directions back from endId and store start..end in path
+    void reconstructPath(const Grid& maze, int startId, int endId, std::vector<Coordinates>& path) const;
+
+    /// Same for searches that record jumpParent(): every cell of each
+    /// straight move is put in the path
+    void reconstructJumpPath(const Grid& maze, int startId, int endId, std::vector<Coordinates>& path) const;
+
+    /// Join the two halves of a bidirectional search: forwardId was reached
+    /// from startId by this workspace, backwardId (the same cell or a
+    /// neighbour) from endId by backward()
+    void reconstructPath(const Grid& maze, int startId, int forwardId, int backwardId, int endId,
+                         std::vector<Coordinates>& path) const;
+
+    /// Empty integer-keyed open list ordering ties by tieBreak. Its
+    /// buckets are kept between runs like the other arrays.
+    BucketQueue<int>& openList(TieBreak tieBreak) {
+        openListUsed_ = true;
+        openList_.clear();
+        openList_.setTieBreak(tieBreak);
+        return openList_;
+    }
+
+    /// Workspace for the search from the end in bidirectional engines,
+    /// created on first use and kept for later runs
+    SearchWorkspace& backward();
+
+    /// Allocator for CellLists and other frontier storage, so it is
+    /// counted with the open list
+    CountingAllocator<int> frontierAllocator() { return CountingAllocator<int>(&frontierMemory_); }
+
+    /// Record the size of a frontier the open list does not see
+    void noteFrontier(std::size_t cells) {
+        if (cells > peakFrontier_) {
+            peakFrontier_ = cells;
+        }
+    }
+
+    /// Counters for per-cell and frontier storage that an engine keeps in
+    /// its own structures
+    MemoryCounter* parentCounter() { return &parentMemory_; }
+    MemoryCounter* frontierCounter() { return &frontierMemory_; }
+
+    /// Memory of the run on maze since the last reset(), the backward
+    /// search included, that produced path
+    void memoryUsage(const Grid& maze, const std::vector<Coordinates>& path, RunMemory& memory) const;
+
+    /// Bytes currently reserved by the workspace arrays
+    std::size_t memoryBytes() const;
+
+private:
+    typedef std::vector<int, CountingAllocator<int>> IntArray;
+
+    void startRun();
+    void searchMemory(RunMemory& memory) const;
+
+    // Declared first: the containers below report to them until destroyed
+    MemoryCounter parentMemory_;
+    MemoryCounter frontierMemory_;
+
+    std::vector<std::uint16_t, CountingAllocator<std::uint16_t>> stamps_;   ///< Epoch each cell was last visited in
+    std::uint16_t epoch_;
+    std::vector<std::uint8_t, CountingAllocator<std::uint8_t>> parents_;
+    IntArray costs_;
+    IntArray jumpParents_;
+    BucketQueue<int> openList_;
+    bool openListUsed_ = false;         ///< openList() was called since the last reset
+    std::size_t peakFrontier_ = 0;      ///< Largest noteFrontier() since the last reset
+    long long pushes_ = 0;
+    std::unique_ptr<SearchWorkspace> backward_;
+};
+
+#endif // SEARCH_WORKSPACE_H
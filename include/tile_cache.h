@@ -0,0 +1,83 @@
+#ifndef TILE_CACHE_H
+#define TILE_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+// Fixed-size blocks of a file kept in memory within a byte budget and
+// evicted least recently used first. Blocks handed out by write() are
+// written back when evicted or on flush(); blocks past the end of the file
+// read as zeros, so a scratch file can start empty and grow sparsely.
+//
+// The block used last is returned again without touching the LRU list, so
+// runs of accesses to one block cost a compare each; recency is updated
+// when the caller moves to another block. Not safe to share between
+// threads.
+class TileCache {
+public:
+    TileCache();
+    ~TileCache();
+
+    /// Cache blocks of blockWords 64-bit words stored from byte offset on in
+    /// fd, which the cache then owns and closes. At least one block is
+    /// kept whatever the budget.
+    void open(int fd, std::uint64_t offset, std::size_t blockWords, std::size_t budgetBytes);
+    void close();
+
+    bool isOpen() const { return fd_ >= 0; }
+
+    /// Block index, paged in if needed. Valid until the next call.
+    const std::uint64_t* read(std::int64_t index) { return index == lastIndex_ ? last_->words.data() : fetch(index)->words.data(); }
+
+    /// Block index for modification, written back on eviction
+    std::uint64_t* write(std::int64_t index) {
+        Block* block = index == lastIndex_ ? last_ : fetch(index);
+        block->dirty = true;
+        return block->words.data();
+    }
+
+    /// Write back every modified block; false on an I/O error
+    bool flush();
+
+    /// False once a read or write-back has failed
+    bool ok() const { return ok_; }
+
+    std::size_t memoryBytes() const { return blocks_.size() * blockWords_ * sizeof(std::uint64_t); }
+    std::size_t capacity() const { return capacity_; }
+
+    long long loads() const { return loads_; }
+    long long evictions() const { return evictions_; }
+    long long writeBacks() const { return writeBacks_; }
+
+private:
+    struct Block {
+        std::int64_t index;
+        bool dirty;
+        std::vector<std::uint64_t> words;
+    };
+
+    Block* fetch(std::int64_t index);
+    bool load(Block& block);
+    bool store(Block& block);
+
+    TileCache(const TileCache&);
+    TileCache& operator=(const TileCache&);
+
+    int fd_;
+    std::uint64_t offset_;
+    std::size_t blockWords_;
+    std::size_t capacity_;
+    std::list<Block> blocks_;   ///< Most recently used first
+    std::unordered_map<std::int64_t, std::list<Block>::iterator> index_;
+    std::int64_t lastIndex_;
+    Block* last_;
+    bool ok_;
+    long long loads_;
+    long long evictions_;
+    long long writeBacks_;
+};
+
+#endif // TILE_CACHE_H
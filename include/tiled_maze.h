@@ -0,0 +1,145 @@
+#ifndef TILED_MAZE_H
+#define TILED_MAZE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+#include "tile_cache.h"
+#include "wall_bitmap.h"
+
+// Position in a tiled maze; 64-bit, as these mazes may outgrow int ids
+using LargeCoordinates = std::pair<std::int64_t, std::int64_t>;
+
+// Tiled maze file (.mzt) for mazes larger than memory: a fixed 64-byte
+// little-endian header followed by square tiles of tileSize x tileSize
+// cells in row-major tile order. Each tile is a wall bitmap of its own,
+// tileSize / 64 words per row, so tile t starts at 64 + t * tile bytes and
+// any cell is one read away. Cells of edge tiles past the maze are walls.
+const char kTiledMazeMagic[4] = {'M', 'Z', 'T', '\0'};
+const std::uint32_t kTiledMazeVersion = 1;
+const int kDefaultTileSize = 256;
+
+/// Cells a tiled maze may hold: the search packs a cell id and a direction
+/// into 64 bits, so ids must fit in 61
+const std::int64_t kMaxTiledCells = std::int64_t(1) << 61;
+
+/// True if a width x height tiled maze has ids the search can pack
+inline bool tiledMazeFits(std::int64_t width, std::int64_t height) {
+    return width > 0 && height > 0 && width <= kMaxTiledCells / height;
+}
+
+struct TiledMazeHeader {
+    char magic[4];              ///< kTiledMazeMagic
+    std::uint32_t version;      ///< kTiledMazeVersion
+    std::int64_t width;
+    std::int64_t height;
+    std::uint32_t tileSize;     ///< Power of two, 64 to 4096
+    std::uint32_t reserved;
+    std::int64_t startX;
+    std::int64_t startY;
+    std::int64_t endX;
+    std::int64_t endY;
+};
+
+static_assert(sizeof(TiledMazeHeader) == 64, "TiledMazeHeader must stay 64 bytes");
+
+/// True if the file starts with a tiled maze header
+bool isTiledMaze(const std::string& filename);
+
+// Writes a tiled maze from rows given top to bottom, holding one band of
+// tileSize rows at a time: memory is tileSize * width / 8 bytes whatever
+// the height.
+class TiledMazeWriter {
+public:
+    TiledMazeWriter();
+    ~TiledMazeWriter();
+
+    /// Start the file; false if it cannot be created or the size or tile
+    /// size is invalid
+    bool open(const std::string& filename, std::int64_t width, std::int64_t height, int tileSize,
+              const LargeCoordinates& start, const LargeCoordinates& end);
+
+    /// Append the next row: (width + 63) / 64 words, bit x set for a wall
+    bool writeRow(const std::uint64_t* words);
+
+    /// Write the last band; false unless every row was written
+    bool close();
+
+private:
+    bool writeBand();
+
+    TiledMazeWriter(const TiledMazeWriter&);
+    TiledMazeWriter& operator=(const TiledMazeWriter&);
+
+    std::FILE* file_;
+    std::string filename_;
+    std::int64_t width_;
+    std::int64_t height_;
+    int tileSize_;
+    std::int64_t tilesX_;
+    std::int64_t rowsWritten_;
+    int bandRows_;
+    std::vector<std::uint64_t> band_;   ///< tileSize rows of tilesX_ * tileSize / 64 words
+    std::vector<std::uint64_t> tile_;
+    bool ok_;
+};
+
+/// Write a whole in-memory maze as a tiled maze file
+bool writeTiledMaze(const std::string& filename, const WallBitmap& walls, int tileSize,
+                    const LargeCoordinates& start, const LargeCoordinates& end);
+
+// Read side of a tiled maze file: tiles are paged in on demand through a
+// TileCache, so memory stays within the cache budget however large the
+// maze. Cell ids are 64-bit, y * width + x.
+class TiledMaze {
+public:
+    TiledMaze();
+
+    /// Open filename keeping at most cacheBytes of tiles in memory; false,
+    /// with a message on stderr, if it is missing or malformed
+    bool open(const std::string& filename, std::size_t cacheBytes);
+
+    std::int64_t width() const { return width_; }
+    std::int64_t height() const { return height_; }
+    int tileSize() const { return tileSize_; }
+    std::int64_t tilesX() const { return tilesX_; }
+    std::int64_t tileCount() const { return tilesX_ * tilesY_; }
+    const LargeCoordinates& start() const { return start_; }
+    const LargeCoordinates& end() const { return end_; }
+
+    std::int64_t cellId(std::int64_t x, std::int64_t y) const { return y * width_ + x; }
+
+    /// Tile holding a cell; cells of one tile share their state in a search
+    std::int64_t tileIndex(std::int64_t x, std::int64_t y) const {
+        return (y >> tileShift_) * tilesX_ + (x >> tileShift_);
+    }
+
+    /// Cells outside the maze count as walls
+    bool isWall(std::int64_t x, std::int64_t y) {
+        if (x < 0 || y < 0 || x >= width_ || y >= height_) {
+            return true;
+        }
+        const std::uint64_t* tile = tiles_.read(tileIndex(x, y));
+        std::int64_t column = x & (tileSize_ - 1);
+        std::int64_t row = y & (tileSize_ - 1);
+        return (tile[(row << (tileShift_ - 6)) + (column >> 6)] >> (column & 63)) & 1u;
+    }
+
+    const TileCache& cache() const { return tiles_; }
+
+private:
+    std::int64_t width_;
+    std::int64_t height_;
+    int tileSize_;
+    int tileShift_;
+    std::int64_t tilesX_;
+    std::int64_t tilesY_;
+    LargeCoordinates start_;
+    LargeCoordinates end_;
+    TileCache tiles_;
+};
+
+#endif // TILED_MAZE_H
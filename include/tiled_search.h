@@ -0,0 +1,39 @@
+#ifndef TILED_SEARCH_H
+#define TILED_SEARCH_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "tiled_maze.h"
+
+enum TiledEngine {
+    TILED_BFS,
+    TILED_ASTAR
+};
+
+/// Engine for "bfs" or "astar"; false for any other key
+bool parseTiledEngine(const std::string& key, TiledEngine& engine);
+
+struct TiledSearchStats {
+    bool found;
+    std::int64_t pathLength;    ///< Cells on the path, start and end included
+    long long openedNodes;
+    long long pushes;
+    long long peakFrontier;     ///< Most cells waiting in the open list at once
+    long long stateLoads;       ///< Search state tiles paged in
+    long long stateWriteBacks;  ///< Search state tiles written out to the scratch file
+    std::size_t stateBytes;     ///< Search state held in memory at the end
+    bool ioOk;                  ///< False if a tile read or write failed
+};
+
+/// Shortest path from maze.start() to maze.end() with BFS or A*, paging
+/// maze tiles in on demand. The per-cell search state (a parent direction
+/// per cell, half a byte) lives in tiles too, in an unlinked scratch file
+/// under $TMPDIR or /tmp with at most stateBudgetBytes of it in memory, so
+/// the search reaches mazes that do not fit in memory as long as the open
+/// list does. The path, start first, is stored only when path is given,
+/// as it may itself be too large; all counters are 64-bit.
+bool findPathTiled(TiledMaze& maze, TiledEngine engine, std::size_t stateBudgetBytes, TiledSearchStats& stats,
+                   std::vector<LargeCoordinates>* path);
+
+#endif // TILED_SEARCH_H
@@ -0,0 +1,26 @@
+#ifndef TRACE_PLAYER_H
+#define TRACE_PLAYER_H
+
+#include <memory>
+#include <string>
+#include "maze_cache.h"
+#include "search_trace.h"
+#include "ui_state.h"
+
+// Playback of a recorded search in the terminal UI. Frame n shows the
+// trace's first n cells (opened cells, then path cells) drawn over the
+// maze. Seeking marks or unmarks only the cells between the current frame
+// and the target, using each cell's marker from before it was drawn, so
+// any speed, step back or jump costs no search work. Returns when the
+// user leaves with Q.
+void playTrace(const Grid& maze, const SearchTrace& trace, UIState& uiState);
+
+// Replay mode: record the selected engine on the selected maze headless at
+// full speed, then play the recording back
+void runReplay(UIState& uiState);
+
+/// Read a trace file and load the maze it was recorded on. False, with a
+/// message on stderr, if either cannot be read or the maze has changed.
+bool openTrace(const std::string& filename, SearchTrace& trace, std::shared_ptr<const CachedMaze>& maze);
+
+#endif // TRACE_PLAYER_H
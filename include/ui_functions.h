@@ -1,19 +1,44 @@
 #ifndef UI_FUNCTIONS_H
 #define UI_FUNCTIONS_H
 
-#include "types.h"
+#include "grid.h"
 #include "ui_state.h"
 
+class MazeRenderer;
+
+// Rectangle of the screen, in rows and columns
+struct ScreenArea {
+    int top, left;
+    int rows, cols;
+};
+
+// Screen placement of the maze inside a ScreenArea. Mazes that fit are
+// centered as a whole; larger ones are shown through a scrollable window
+// of cells with a downsampled minimap of the whole maze beside it.
+struct MazeLayout {
+    int top, left;        ///< Screen position of the first visible cell
+    int rows, cols;       ///< Visible maze rows and columns
+    bool scrolled;        ///< Whether the maze is larger than the view
+    int minimap_top, minimap_left; ///< Screen position of the first minimap block
+    int minimap_rows, minimap_cols; ///< Minimap size in blocks (0 when hidden)
+    int block;            ///< Maze cells per minimap block along each axis
+};
+
 void initColors();
-void drawMaze(const Matrix& maze, const UIState& state);
+ScreenArea mazeArea();
+MazeLayout mazeLayout(const Grid& maze, const ScreenArea& area);
+void clampView(const Grid& maze, const MazeLayout& layout, UIState& state);
+void drawMazeCell(int screen_y, int screen_x, int cell);
 void updateStatus(const UIState& state);
+void changeSpeed(UIState& state, bool faster);
+void scrollView(UIState& state, int key);
 int handleInput(UIState& state);
-void handleInputDuringDelay(UIState& state, const Matrix& maze, double delay);
+void handleInputDuringDelay(UIState& state, MazeRenderer& renderer, double delay);
 void drawInfoPanel(const UIState& state);
-void checkTerminalSize(const Matrix& maze, UIState& state);
+void checkTerminalSize(UIState& state);
 void cleanupUI();
 void showFinalResult(const UIState& state, size_t pathLength);
 void drawMenuBox(int start_y, int end_y, int start_x, int end_x);
 void drawHeader();
 
-#endif // UI_FUNCTIONS_H 
\ No newline at end of file
+#endif // UI_FUNCTIONS_H
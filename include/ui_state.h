@@ -10,8 +10,14 @@ struct UIState {
     bool paused;         ///< Whether the algorithm is paused
     bool finished;       ///< Whether the algorithm has finished
     bool restart_requested; ///< Whether a restart has been requested
+    bool edit_requested; ///< Whether the results screen asked for the maze editor
     bool user_quit;      ///< Whether the user quit the algorithm
     
+    // Viewport
+    int view_x;          ///< Maze column shown at the left edge of the map
+    int view_y;          ///< Maze row shown at the top edge of the map
+    bool follow_frontier; ///< Whether the view tracks the search frontier
+    
     // Statistics
     int opened_nodes;    ///< Number of nodes explored by the current algorithm
     
@@ -19,6 +25,9 @@ struct UIState {
     int current_algorithm;   ///< Index of the currently selected algorithm
     int current_file;        ///< Index of the currently selected maze file
     double speed;            ///< Animation speed in seconds per step
+    bool race_requested;     ///< Whether the menu asked for a race instead of a single run
+    std::vector<bool> race_selection; ///< Engines taking part in a race, by algorithm index
+    bool replay_requested;   ///< Whether the menu asked to record the search and play it back
     int selected_option;     ///< Currently selected menu option
     
     // Available options
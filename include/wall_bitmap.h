@@ -0,0 +1,37 @@
+#ifndef WALL_BITMAP_H
+#define WALL_BITMAP_H
+
+#include <vector>
+#include <cstdint>
+
+// Maze walls packed one bit per cell (1 = wall). Each row is padded to a
+// whole number of 64-bit words so rows can be processed word-at-a-time.
+class WallBitmap {
+public:
+    WallBitmap() : width_(0), height_(0), wordsPerRow_(0) {}
+    WallBitmap(int width, int height)
+        : width_(width), height_(height), wordsPerRow_((width + 63) / 64),
+          words_(static_cast<std::size_t>(wordsPerRow_) * height, 0) {}
+
+    int width() const { return width_; }
+    int height() const { return height_; }
+    int wordsPerRow() const { return wordsPerRow_; }
+
+    std::uint64_t* row(int y) { return &words_[static_cast<std::size_t>(y) * wordsPerRow_]; }
+    const std::uint64_t* row(int y) const { return &words_[static_cast<std::size_t>(y) * wordsPerRow_]; }
+
+    bool isWall(int x, int y) const { return (row(y)[x >> 6] >> (x & 63)) & 1u; }
+    void setWall(int x, int y) { row(y)[x >> 6] |= std::uint64_t(1) << (x & 63); }
+    void clearWall(int x, int y) { row(y)[x >> 6] &= ~(std::uint64_t(1) << (x & 63)); }
+
+    const std::vector<std::uint64_t>& words() const { return words_; }
+    std::vector<std::uint64_t>& words() { return words_; }
+
+private:
+    int width_;
+    int height_;
+    int wordsPerRow_;
+    std::vector<std::uint64_t> words_;
+};
+
+#endif // WALL_BITMAP_H
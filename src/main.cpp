@@ -3,6 +3,9 @@
 #include "../include/ui_functions.h"
 #include "../include/menu_manager.h"
 #include "../include/app_manager.h"
+#include "../include/command_line.h"
+#include "../include/race_manager.h"
+#include "../include/trace_player.h"
 #include <iostream>
 #include <ncurses.h>
 
@@ -12,7 +15,19 @@ UIState uiState;
 bool programRunning = true;
 
 
-int main() {
+int main(int argc, char** argv) {
+    // A recorded trace is played in the terminal UI; any other arguments
+    // are scripted solves, which never touch the terminal
+    SearchTrace trace;
+    std::shared_ptr<const CachedMaze> traceMaze;
+    if (argc == 3 && std::string(argv[1]) == "--replay") {
+        if (!openTrace(argv[2], trace, traceMaze)) {
+            return 2;
+        }
+    } else if (argc > 1) {
+        return runCommandLine(argc, argv);
+    }
+
     // Initialize ncurses
     initscr();
     noecho();
@@ -23,13 +38,25 @@ int main() {
     initColors();
     
     initializeApplication(uiState);
+
+    if (traceMaze) {
+        playTrace(traceMaze->maze, trace, uiState);
+        endwin();
+        return 0;
+    }
     
     while (programRunning) {
         bool should_run_algorithm = showMainMenu(uiState, programRunning);
         
         // Handle "LETS GO!" selection from main menu
         if (should_run_algorithm && programRunning) {
-            runAlgorithm(uiState);
+            if (uiState.race_requested) {
+                runRace(uiState);
+            } else if (uiState.replay_requested) {
+                runReplay(uiState);
+            } else {
+                runAlgorithm(uiState);
+            }
         }
     }
     
@@ -0,0 +1,51 @@
+// Converts mazes between the text format and the binary .mzb format.
+//
+// Usage: ./maze_convert <input> <output>
+// The output format follows the output extension: ".mzb" writes binary,
+// ".mzt" a tiled maze, anything else writes text. The input format is
+// detected automatically.
+
+#include "../include/binary_maze.h"
+#include "../include/maze_loader.h"
+#include "../include/tiled_maze.h"
+#include <cstdio>
+#include <string>
+
+static bool endsWith(const std::string& value, const std::string& suffix) {
+    return value.size() >= suffix.size() && value.compare(value.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::fprintf(stderr, "Usage: %s <input> <output>\n", argv[0]);
+        std::fprintf(stderr, "Writes a binary maze when output ends in .mzb, a tiled maze for .mzt, text otherwise.\n");
+        return 2;
+    }
+
+    std::string input = argv[1];
+    std::string output = argv[2];
+
+    Coordinates start, end;
+    Grid maze = readMaze(input, start, end);
+    if (maze.empty()) {
+        return 1;
+    }
+
+    WallBitmap walls = maze.walls();
+    bool ok;
+    if (endsWith(output, ".mzb")) {
+        ok = writeBinaryMaze(output, walls, start, end);
+    } else if (endsWith(output, ".mzt")) {
+        ok = writeTiledMaze(output, walls, kDefaultTileSize, LargeCoordinates(start.first, start.second),
+                            LargeCoordinates(end.first, end.second));
+    } else {
+        ok = writeTextMaze(output, walls, start, end);
+    }
+    if (!ok) {
+        return 1;
+    }
+
+    std::printf("%s -> %s: %dx%d, content hash %016llx\n", input.c_str(), output.c_str(),
+                maze.width(), maze.height(), static_cast<unsigned long long>(hashWalls(walls)));
+    return 0;
+}
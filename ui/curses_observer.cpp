@@ -0,0 +1,84 @@
+#include "../include/curses_observer.h"
+#include "../include/ui_functions.h"
+#include <ncurses.h>
+#include <unistd.h>
+
+namespace {
+
+// Upper bound on screen repaints, independent of the search step rate
+const std::chrono::microseconds kFrameInterval(1000000 / 60);
+
+} // namespace
+
+CursesSearchObserver::CursesSearchObserver(UIState& state, MazeRenderer& renderer)
+    : state_(state), renderer_(renderer), lastFrame_(std::chrono::steady_clock::now() - kFrameInterval) {}
+
+bool CursesSearchObserver::onExpand(const Grid& /* maze */, int cell, int openedNodes) {
+    state_.opened_nodes = openedNodes;
+    renderer_.mark(cell, CELL_EXPLORED);
+    renderer_.follow(state_, cell);
+    if (std::chrono::steady_clock::now() - lastFrame_ >= kFrameInterval) {
+        presentFrame();
+    }
+    handleInputDuringDelay(state_, renderer_, state_.speed);
+
+    return pollControls();
+}
+
+void CursesSearchObserver::onPathFound(const Grid& maze, const std::vector<Coordinates>& path) {
+    for (const Coordinates& p : path) {
+        renderer_.mark(maze.index(p), CELL_FINAL_PATH);
+    }
+    presentFrame();
+}
+
+void CursesSearchObserver::presentFrame() {
+    renderer_.flush(state_);
+    updateStatus(state_);
+    refresh();
+    lastFrame_ = std::chrono::steady_clock::now();
+}
+
+bool CursesSearchObserver::pollControls() {
+    while (true) {
+        // Check for immediate quit first
+        if (state_.user_quit) {
+            return false;
+        }
+
+        // Handle user input
+        int inputResult = handleInput(state_);
+        if (inputResult == 0) {
+            return false; // User quit or stopped
+        }
+        if (inputResult == 4) {
+            return false; // Immediate quit
+        }
+        if (inputResult == 2) {
+            // Terminal resized: the only time the whole maze is repainted
+            renderer_.redrawAll(state_);
+            updateStatus(state_);
+            refresh();
+        }
+        if (inputResult == 3) {
+            // View scrolled or follow toggled
+            renderer_.invalidateView();
+            presentFrame();
+        }
+
+        // Check for restart request
+        if (state_.restart_requested) {
+            return false; // Stop current algorithm to trigger restart
+        }
+
+        if (state_.running) {
+            return true;
+        }
+
+        // Paused: keep the screen current while waiting
+        if (renderer_.hasPending()) {
+            presentFrame();
+        }
+        usleep(10000); // Small delay when paused
+    }
+}
@@ -0,0 +1,134 @@
+#include "../include/maze_editor.h"
+#include "../include/algorithms.h"
+#include "../include/d_star_lite.h"
+#include "../include/ui_functions.h"
+#include <chrono>
+#include <ncurses.h>
+#include <utility>
+
+namespace {
+
+// Collects the cells a repair expanded so they can be shown and cleared
+class RepairObserver : public SearchObserver {
+public:
+    explicit RepairObserver(std::vector<int>& expanded) : expanded_(expanded) {}
+
+    bool onExpand(const Grid&, int cell, int) override {
+        expanded_.push_back(cell);
+        return true;
+    }
+    void onPathFound(const Grid&, const std::vector<Coordinates>&) override {}
+
+private:
+    std::vector<int>& expanded_;
+};
+
+void drawEditStatus(const UIState& uiState, bool pathFound, std::size_t pathLength, int openedNodes, double repairMs) {
+    int max_x, max_y;
+    getmaxyx(stdscr, max_y, max_x);
+    updateStatus(uiState);
+    for (int x = 0; x < max_x; x++) {
+        mvaddch(max_y - 1, x, ' ');
+    }
+    attron(COLOR_PAIR(4));
+    if (pathFound) {
+        mvprintw(max_y - 1, 2, "Edit: Arrows=Move, Space=Toggle wall, E=Done | Repair: %d cells, %.3f ms, path %zu",
+                 openedNodes, repairMs, pathLength);
+    } else {
+        mvprintw(max_y - 1, 2, "Edit: Arrows=Move, Space=Toggle wall, E=Done | Repair: %d cells, %.3f ms, no path",
+                 openedNodes, repairMs);
+    }
+    attroff(COLOR_PAIR(4));
+    refresh();
+}
+
+} // namespace
+
+bool editMaze(Grid& maze, const Coordinates& start, const Coordinates& end, MazeRenderer& renderer,
+              UIState& uiState, std::vector<Coordinates>& path, int& openedNodes) {
+    int startId = maze.index(start);
+    int endId = maze.index(end);
+    std::vector<int> expanded;
+    RepairObserver observer(expanded);
+    DStarLite planner(maze, startId, endId);
+
+    // Swap the last repair's markers for the new one's
+    auto repair = [&]() {
+        for (int cell : expanded) {
+            renderer.mark(cell, CELL_PATH);
+        }
+        for (const Coordinates& p : path) {
+            renderer.mark(maze.index(p), CELL_PATH);
+        }
+        expanded.clear();
+        openedNodes = 0;
+        auto repairStart = std::chrono::steady_clock::now();
+        planner.plan(observer, openedNodes);
+        double repairMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - repairStart).count();
+        bool found = planner.path(path);
+        for (int cell : expanded) {
+            renderer.mark(cell, CELL_EXPLORED);
+        }
+        for (const Coordinates& p : path) {
+            renderer.mark(maze.index(p), CELL_FINAL_PATH);
+        }
+        uiState.opened_nodes = openedNodes;
+        return std::make_pair(found, repairMs);
+    };
+
+    // Solve the unedited maze once so later edits have something to repair
+    path.clear();
+    renderer.clearMarks();
+    std::pair<bool, double> result = repair();
+    int cursor = startId;
+    uiState.follow_frontier = true;
+    renderer.setCursor(cursor);
+    clear();
+    renderer.redrawAll(uiState);
+    renderer.follow(uiState, cursor);
+    renderer.flush(uiState);
+    drawEditStatus(uiState, result.first, path.size(), openedNodes, result.second);
+
+    while (true) {
+        int ch = getch();
+        int moved = cursor;
+        switch (ch) {
+            case KEY_LEFT:  moved = cursor + maze.offset(0); break;
+            case KEY_RIGHT: moved = cursor + maze.offset(1); break;
+            case KEY_UP:    moved = cursor + maze.offset(2); break;
+            case KEY_DOWN:  moved = cursor + maze.offset(3); break;
+            case ' ':
+                if (cursor != startId && cursor != endId) {
+                    maze.setWall(cursor, maze[cursor] != CELL_WALL);
+                    renderer.wallChanged(cursor);
+                    planner.cellChanged(cursor);
+                    result = repair();
+                }
+                break;
+            case 'w': case 'W': case 'a': case 'A': case 's': case 'S': case 'd': case 'D':
+                scrollView(uiState, ch);
+                renderer.invalidateView();
+                break;
+            case KEY_RESIZE:
+                clear();
+                renderer.redrawAll(uiState);
+                break;
+            case 'e': case 'E': case 'q': case 'Q':
+                renderer.setCursor(-1);
+                renderer.flush(uiState);
+                return result.first;
+        }
+
+        // Cursor stays inside the maze; the view follows it again once it moves
+        Coordinates position = maze.coordinates(moved);
+        if (moved != cursor && position.first >= 0 && position.first < maze.width() &&
+            position.second >= 0 && position.second < maze.height()) {
+            cursor = moved;
+            renderer.setCursor(cursor);
+            uiState.follow_frontier = true;
+            renderer.follow(uiState, cursor);
+        }
+        renderer.flush(uiState);
+        drawEditStatus(uiState, result.first, path.size(), openedNodes, result.second);
+    }
+}
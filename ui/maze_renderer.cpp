@@ -0,0 +1,203 @@
+#include "../include/maze_renderer.h"
+#include <ncurses.h>
+#include <algorithm>
+
+MazeRenderer::MazeRenderer(const Grid& maze)
+    : maze_(maze), marks_(maze.cellCount(), CELL_PATH), area_(), hasArea_(false), layout_(),
+      viewDirty_(false), cursor_(-1), startBlock_(-1), endBlock_(-1) {}
+
+int MazeRenderer::blockOf(int cell) const {
+    Coordinates position = maze_.coordinates(cell);
+    return (position.second / layout_.block) * layout_.minimap_cols + position.first / layout_.block;
+}
+
+void MazeRenderer::mark(int cell, int kind) {
+    if (maze_[cell] == CELL_START || maze_[cell] == CELL_END) {
+        return;
+    }
+    if (layout_.minimap_cols > 0) {
+        int block = blockOf(cell);
+        exploredCells_[block] += (kind == CELL_EXPLORED) - (marks_[cell] == CELL_EXPLORED);
+        pathCells_[block] += (kind == CELL_FINAL_PATH) - (marks_[cell] == CELL_FINAL_PATH);
+    }
+    marks_[cell] = static_cast<std::int8_t>(kind);
+    dirty_.push_back(cell);
+}
+
+void MazeRenderer::clearMarks() {
+    std::fill(marks_.begin(), marks_.end(), static_cast<std::int8_t>(CELL_PATH));
+    std::fill(exploredCells_.begin(), exploredCells_.end(), 0);
+    std::fill(pathCells_.begin(), pathCells_.end(), 0);
+    dirty_.clear();
+    viewDirty_ = true;
+}
+
+void MazeRenderer::wallChanged(int cell) {
+    // Walls carry no markers
+    mark(cell, CELL_PATH);
+    if (layout_.minimap_cols > 0) {
+        openCells_[blockOf(cell)] += maze_[cell] == CELL_WALL ? -1 : 1;
+    }
+}
+
+void MazeRenderer::setCursor(int cell) {
+    if (cursor_ >= 0) {
+        dirty_.push_back(cursor_);
+    }
+    cursor_ = cell;
+    if (cursor_ >= 0) {
+        dirty_.push_back(cursor_);
+    }
+}
+
+void MazeRenderer::drawCell(int screen_y, int screen_x, int cell) {
+    drawMazeCell(screen_y, screen_x, cellKind(cell));
+    if (cell == cursor_) {
+        mvaddch(screen_y, screen_x, mvinch(screen_y, screen_x) | A_REVERSE);
+    }
+}
+
+void MazeRenderer::follow(UIState& state, int cell) {
+    if (!state.follow_frontier || !layout_.scrolled) {
+        return;
+    }
+    Coordinates position = maze_.coordinates(cell);
+    int margin_x = layout_.cols / 8;
+    int margin_y = layout_.rows / 8;
+    if (position.first < state.view_x + margin_x || position.first >= state.view_x + layout_.cols - margin_x ||
+        position.second < state.view_y + margin_y || position.second >= state.view_y + layout_.rows - margin_y) {
+        int view_x = state.view_x;
+        int view_y = state.view_y;
+        state.view_x = position.first - layout_.cols / 2;
+        state.view_y = position.second - layout_.rows / 2;
+        clampView(maze_, layout_, state);
+        if (state.view_x != view_x || state.view_y != view_y) {
+            viewDirty_ = true;
+        }
+    }
+}
+
+void MazeRenderer::paintView(const UIState& state) {
+    for (int y = 0; y < layout_.rows; y++) {
+        int row = maze_.index(state.view_x, state.view_y + y);
+        for (int x = 0; x < layout_.cols; x++) {
+            drawCell(layout_.top + y, layout_.left + x, row + x);
+        }
+    }
+}
+
+void MazeRenderer::flush(UIState& state) {
+    if (viewDirty_) {
+        clampView(maze_, layout_, state);
+        paintView(state);
+        viewDirty_ = false;
+    } else {
+        for (int cell : dirty_) {
+            Coordinates position = maze_.coordinates(cell);
+            int x = position.first - state.view_x;
+            int y = position.second - state.view_y;
+            if (x >= 0 && x < layout_.cols && y >= 0 && y < layout_.rows) {
+                drawCell(layout_.top + y, layout_.left + x, cell);
+            }
+        }
+    }
+    dirty_.clear();
+    drawMinimap(state);
+}
+
+void MazeRenderer::redrawAll(UIState& state) {
+    int block = layout_.block;
+    int minimap_cols = layout_.minimap_cols;
+    layout_ = mazeLayout(maze_, hasArea_ ? area_ : mazeArea());
+    clampView(maze_, layout_, state);
+    if (layout_.block != block || layout_.minimap_cols != minimap_cols || openCells_.empty()) {
+        countBlocks();
+    }
+
+    dirty_.clear();
+    viewDirty_ = false;
+    drawHeader();
+    paintView(state);
+    if (layout_.minimap_cols > 0) {
+        drawMenuBox(layout_.minimap_top - 1, layout_.minimap_top + layout_.minimap_rows,
+                    layout_.minimap_left - 1, layout_.minimap_left + layout_.minimap_cols);
+    }
+    drawMinimap(state);
+}
+
+// Rebuild the per-block counts from the grid; only needed when the block
+// size changes, i.e. on the first frame and after a resize
+void MazeRenderer::countBlocks() {
+    std::size_t blocks = static_cast<std::size_t>(layout_.minimap_rows) * layout_.minimap_cols;
+    openCells_.assign(blocks, 0);
+    exploredCells_.assign(blocks, 0);
+    pathCells_.assign(blocks, 0);
+    startBlock_ = -1;
+    endBlock_ = -1;
+    if (blocks == 0) {
+        return;
+    }
+
+    for (int y = 0; y < maze_.height(); y++) {
+        int row = (y / layout_.block) * layout_.minimap_cols;
+        int first = maze_.index(0, y);
+        for (int x = 0; x < maze_.width(); x++) {
+            int block = row + x / layout_.block;
+            int cell = cellKind(first + x);
+            openCells_[block] += cell != CELL_WALL;
+            exploredCells_[block] += cell == CELL_EXPLORED;
+            if (cell == CELL_FINAL_PATH) {
+                ++pathCells_[block];
+            } else if (cell == CELL_START) {
+                startBlock_ = block;
+            } else if (cell == CELL_END) {
+                endBlock_ = block;
+            }
+        }
+    }
+}
+
+void MazeRenderer::drawMinimap(const UIState& state) {
+    if (layout_.minimap_cols == 0) {
+        return;
+    }
+
+    // Explored share of the open cells in a block, in quarters
+    static const char density[] = {'.', ':', 'o', 'O'};
+
+    int view_left = state.view_x / layout_.block;
+    int view_right = (state.view_x + layout_.cols - 1) / layout_.block;
+    int view_top = state.view_y / layout_.block;
+    int view_bottom = (state.view_y + layout_.rows - 1) / layout_.block;
+
+    for (int by = 0; by < layout_.minimap_rows; by++) {
+        for (int bx = 0; bx < layout_.minimap_cols; bx++) {
+            int block = by * layout_.minimap_cols + bx;
+            chtype symbol;
+            if (pathCells_[block] > 0) {
+                symbol = '*' | COLOR_PAIR(5);
+            } else if (openCells_[block] == 0) {
+                symbol = '#' | COLOR_PAIR(9);
+            } else if (exploredCells_[block] > 0) {
+                int level = std::min(3, exploredCells_[block] * 4 / openCells_[block]);
+                symbol = density[level] | COLOR_PAIR(7);
+            } else {
+                symbol = ' ';
+            }
+            if (bx >= view_left && bx <= view_right && by >= view_top && by <= view_bottom) {
+                symbol |= A_REVERSE;
+            }
+            mvaddch(layout_.minimap_top + by, layout_.minimap_left + bx, symbol);
+        }
+    }
+
+    // Endpoints are drawn last so they stay visible whatever the block holds
+    if (startBlock_ >= 0) {
+        mvaddch(layout_.minimap_top + startBlock_ / layout_.minimap_cols,
+                layout_.minimap_left + startBlock_ % layout_.minimap_cols, 'S' | COLOR_PAIR(5) | A_BOLD);
+    }
+    if (endBlock_ >= 0) {
+        mvaddch(layout_.minimap_top + endBlock_ / layout_.minimap_cols,
+                layout_.minimap_left + endBlock_ % layout_.minimap_cols, 'E' | COLOR_PAIR(6) | A_BOLD);
+    }
+}
@@ -3,6 +3,16 @@
 #include <ncurses.h>
 #include <algorithm>
 
+namespace {
+
+// Rows from one menu option to the next: a blank line between options when
+// the whole list fits that way below the header, none otherwise
+int optionSpacing(int count, int max_y) {
+    return count * 2 + 3 <= max_y - 2 ? 2 : 1;
+}
+
+} // namespace
+
 void drawButton(int y, int x, const std::string& text, bool selected) {
     if (selected) {
         attron(A_REVERSE | COLOR_PAIR(2));
@@ -37,6 +47,8 @@ bool showMainMenu(UIState& uiState, bool& programRunning) {
         "Select Maze",
         "Select Algorithm", 
         "Adjust Speed",
+        "Race Algorithms",
+        "Replay Search",
         "Quit"
     };
     
@@ -99,6 +111,8 @@ bool showMainMenu(UIState& uiState, bool& programRunning) {
         case 10:  // Enter
             switch (uiState.selected_option) {
                 case 0:  // Start Pathfinding
+                    uiState.race_requested = false;
+                    uiState.replay_requested = false;
                     return true;  // Signal to run the algorithm
                 case 1:  // Select File
                     showFileSelection(uiState);
@@ -109,7 +123,18 @@ bool showMainMenu(UIState& uiState, bool& programRunning) {
                 case 3:  // Adjust Speed
                     showSpeedSelection(uiState);
                     break;
-                case 4:  // Quit
+                case 4:  // Race Algorithms
+                    if (showRaceSelection(uiState)) {
+                        uiState.race_requested = true;
+                        uiState.replay_requested = false;
+                        return true;
+                    }
+                    break;
+                case 5:  // Replay Search
+                    uiState.race_requested = false;
+                    uiState.replay_requested = true;
+                    return true;
+                case 6:  // Quit
                     programRunning = false;
                     break;
             }
@@ -141,7 +166,8 @@ void showFileSelection(UIState& uiState) {
         }
         int button_width = max_file_width + 6;
         int box_width = button_width + 6;
-        int box_height = 1 + 1 + static_cast<int>(uiState.files.size()) * 2 - 1 + 2;
+        int spacing = optionSpacing(static_cast<int>(uiState.files.size()), max_y);
+        int box_height = 1 + 1 + (static_cast<int>(uiState.files.size()) - 1) * spacing + 1 + 2;
         
         // Center the menu box
         int box_start_x = (max_x - box_width) / 2;
@@ -171,7 +197,7 @@ void showFileSelection(UIState& uiState) {
             }
             int available = inner_width - static_cast<int>(button_str.length());
             int x = box_start_x + 2 + (available + 1) / 2 - (available % 2);
-            drawButton(option_start_y + static_cast<int>(i) * 2, x, uiState.files[i], static_cast<int>(i) == uiState.selected_option);
+            drawButton(option_start_y + static_cast<int>(i) * spacing, x, uiState.files[i], static_cast<int>(i) == uiState.selected_option);
         }
         
         // Draw instructions
@@ -220,7 +246,8 @@ void showAlgorithmSelection(UIState& uiState) {
         }
         int button_width = max_alg_width + 6;
         int box_width = button_width + 6;
-        int box_height = 1 + 1 + static_cast<int>(uiState.algorithms.size()) * 2 - 1 + 2;
+        int spacing = optionSpacing(static_cast<int>(uiState.algorithms.size()), max_y);
+        int box_height = 1 + 1 + (static_cast<int>(uiState.algorithms.size()) - 1) * spacing + 1 + 2;
         
         // Center the menu box
         int box_start_x = (max_x - box_width) / 2;
@@ -250,7 +277,7 @@ void showAlgorithmSelection(UIState& uiState) {
             }
             int available = inner_width - static_cast<int>(button_str.length());
             int x = box_start_x + 2 + (available + 1) / 2 - (available % 2);
-            drawButton(option_start_y + static_cast<int>(i) * 2, x, uiState.algorithms[i], static_cast<int>(i) == uiState.selected_option);
+            drawButton(option_start_y + static_cast<int>(i) * spacing, x, uiState.algorithms[i], static_cast<int>(i) == uiState.selected_option);
         }
         
         // Draw instructions
@@ -358,4 +385,85 @@ void showSpeedSelection(UIState& uiState) {
                 return;
         }
     }
-} 
\ No newline at end of file
+}
+
+// Toggle the engines that take part in a race; true to start it, false
+// when the user backs out
+bool showRaceSelection(UIState& uiState) {
+    int cursor = 0;
+    int count = static_cast<int>(uiState.algorithms.size());
+    
+    while (true) {
+        clear();
+        drawHeader();
+        
+        int max_x, max_y;
+        getmaxyx(stdscr, max_y, max_x);
+        
+        // Calculate box dimensions for the checklist
+        int max_alg_width = 0;
+        for (const std::string& alg : uiState.algorithms) {
+            max_alg_width = std::max(max_alg_width, static_cast<int>(alg.length()) + 4);
+        }
+        int button_width = max_alg_width + 6;
+        int box_width = std::max(button_width + 6, 24);
+        int spacing = optionSpacing(count, max_y);
+        int box_height = 1 + 1 + (count - 1) * spacing + 1 + 2;
+        
+        // Center the menu box
+        int box_start_x = (max_x - box_width) / 2;
+        int box_start_y = (max_y - box_height) / 2;
+        int box_end_x = box_start_x + box_width;
+        int box_end_y = box_start_y + box_height;
+        
+        // Draw menu box
+        drawMenuBox(box_start_y, box_end_y, box_start_x, box_end_x);
+        
+        // Draw menu title
+        std::string menu_title = "RACE ALGORITHMS";
+        int title_x = box_start_x + (box_width - static_cast<int>(menu_title.length())) / 2 + 1;
+        attron(A_BOLD | COLOR_PAIR(1));
+        mvprintw(box_start_y + 1, title_x, "%s", menu_title.c_str());
+        attroff(A_BOLD | COLOR_PAIR(1));
+        
+        // Draw one checkbox per algorithm, left aligned
+        int option_start_y = box_start_y + 3;
+        int x = box_start_x + (box_width - button_width) / 2 + 1;
+        for (int i = 0; i < count; i++) {
+            std::string label = std::string(uiState.race_selection[i] ? "[x] " : "[ ] ") + uiState.algorithms[i];
+            label.resize(max_alg_width, ' ');
+            drawButton(option_start_y + i * spacing, x, label, i == cursor);
+        }
+        
+        // Draw instructions
+        attron(COLOR_PAIR(4));
+        mvprintw(max_y - 1, 0, "Navigation: Up/Down | Toggle: Space | Start: Enter | Back: Q");
+        attroff(COLOR_PAIR(4));
+        
+        refresh();
+        
+        // Handle input
+        int ch = getch();
+        switch (ch) {
+            case KEY_UP:
+                cursor = (cursor - 1 + count) % count;
+                break;
+            case KEY_DOWN:
+                cursor = (cursor + 1) % count;
+                break;
+            case ' ':
+                uiState.race_selection[cursor] = !uiState.race_selection[cursor];
+                break;
+            case 10:  // Enter
+                // A race needs at least one runner
+                if (std::find(uiState.race_selection.begin(), uiState.race_selection.end(), true) !=
+                    uiState.race_selection.end()) {
+                    return true;
+                }
+                break;
+            case 'q':
+            case 'Q':
+                return false;
+        }
+    }
+}
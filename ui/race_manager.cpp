@@ -0,0 +1,455 @@
+#include "../include/race_manager.h"
+#include "../include/algorithms.h"
+#include "../include/app_manager.h"
+#include "../include/maze_cache.h"
+#include "../include/maze_renderer.h"
+#include "../include/ui_functions.h"
+#include <ncurses.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+// Upper bound on screen repaints while the engines run
+const std::chrono::microseconds kFrameInterval(1000000 / 60);
+
+// Bottom rows used by the per-engine stat boxes and the controls line
+const int kStatsRows = 7;
+
+// Set by the UI thread, read by every engine thread
+struct RaceControl {
+    std::atomic<bool> stop;
+    std::atomic<bool> paused;
+    std::atomic<int> delayUs;   ///< Pause after every opened node
+};
+
+// What the UI last took over from an engine thread
+struct LaneSnapshot {
+    int openedNodes;
+    bool finished;
+    bool found;
+    std::size_t pathLength;
+    double searchMs;
+};
+
+// One engine in the race. The engine thread publishes progress under the
+// mutex; the UI thread takes it over once per frame and owns everything
+// below the snapshot.
+struct RaceLane {
+    const AlgorithmInfo* algorithm;
+
+    std::mutex mutex;
+    std::vector<int> expanded;      ///< Cells opened since the last frame
+    std::vector<Coordinates> path;
+    LaneSnapshot progress;
+
+    LaneSnapshot shown;
+    std::unique_ptr<MazeRenderer> renderer;
+    ScreenArea pane;
+    bool pathDrawn;
+};
+
+typedef std::vector<std::unique_ptr<RaceLane>> RaceLanes;
+
+// Engine-side observer: hands opened cells to the lane and applies the
+// shared pacing and pause state. Never touches curses.
+class RaceObserver : public SearchObserver {
+public:
+    RaceObserver(RaceLane& lane, RaceControl& control) : lane_(lane), control_(control), waited_(0) {}
+
+    bool onExpand(const Grid&, int cell, int openedNodes) override {
+        {
+            std::lock_guard<std::mutex> lock(lane_.mutex);
+            lane_.expanded.push_back(cell);
+            lane_.progress.openedNodes = openedNodes;
+        }
+        if (control_.delayUs > 0 || control_.paused) {
+            Clock::time_point waitStart = Clock::now();
+            wait();
+            waited_ += Clock::now() - waitStart;
+        }
+        return !control_.stop;
+    }
+
+    void onPathFound(const Grid&, const std::vector<Coordinates>& path) override {
+        std::lock_guard<std::mutex> lock(lane_.mutex);
+        lane_.path = path;
+    }
+
+    /// Time spent pacing or paused, excluded from the engine's search time
+    Clock::duration waited() const { return waited_; }
+
+private:
+    // Sleep in short slices so stop and pause take effect quickly
+    void wait() {
+        int remaining = control_.delayUs;
+        while (!control_.stop && (remaining > 0 || control_.paused)) {
+            bool paused = control_.paused;
+            int slice = paused ? 10000 : std::min(remaining, 10000);
+            usleep(slice);
+            if (!paused) {
+                remaining -= slice;
+            }
+        }
+    }
+
+    RaceLane& lane_;
+    RaceControl& control_;
+    Clock::duration waited_;
+};
+
+void runLane(const Grid& maze, const Coordinates& start, const Coordinates& end, RaceLane& lane,
+             RaceControl& control) {
+    SearchWorkspace workspace;
+    RaceObserver observer(lane, control);
+    std::vector<Coordinates> path;
+    int openedNodes = 0;
+
+    Clock::time_point begin = Clock::now();
+    bool found = lane.algorithm->run(maze, start, end, path, openedNodes, workspace, observer);
+    Clock::duration elapsed = Clock::now() - begin - observer.waited();
+
+    std::lock_guard<std::mutex> lock(lane.mutex);
+    lane.progress.openedNodes = openedNodes;
+    lane.progress.finished = true;
+    lane.progress.found = found;
+    lane.progress.pathLength = found ? path.size() : 0;
+    lane.progress.searchMs = std::chrono::duration<double, std::milli>(elapsed).count();
+}
+
+// mvprintw cut to width columns, for boxes that get narrow with many engines
+void printClipped(int y, int x, int width, const char* format, ...) {
+    char text[256];
+    va_list args;
+    va_start(args, format);
+    std::vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    mvprintw(y, x, "%.*s", std::max(width, 0), text);
+}
+
+// Split the screen above the stat boxes into a grid of panes
+void layoutPanes(RaceLanes& lanes) {
+    int max_x, max_y;
+    getmaxyx(stdscr, max_y, max_x);
+
+    int count = static_cast<int>(lanes.size());
+    int columns = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(count))));
+    int rows = (count + columns - 1) / columns;
+    int pane_height = (max_y - 1 - kStatsRows) / rows;
+    int pane_width = max_x / columns;
+
+    for (int i = 0; i < count; ++i) {
+        RaceLane& lane = *lanes[i];
+        ScreenArea pane = {1 + (i / columns) * pane_height, (i % columns) * pane_width, pane_height, pane_width};
+        ScreenArea inside = {pane.top + 1, pane.left + 1, pane.rows - 2, pane.cols - 2};
+        lane.pane = pane;
+        lane.renderer->setArea(inside);
+    }
+}
+
+void drawPaneFrame(const RaceLane& lane) {
+    const ScreenArea& pane = lane.pane;
+    drawMenuBox(pane.top, pane.top + pane.rows - 1, pane.left, pane.left + pane.cols - 1);
+    attron(A_BOLD | COLOR_PAIR(3));
+    mvprintw(pane.top, pane.left + 2, " %s ", lane.algorithm->name.c_str());
+    attroff(A_BOLD | COLOR_PAIR(3));
+}
+
+// Move new progress from the engine threads onto the screen. Returns true
+// once every engine has finished.
+bool pumpLanes(const Grid& maze, RaceLanes& lanes, UIState& state) {
+    bool allFinished = true;
+    std::vector<int> cells;
+    for (std::unique_ptr<RaceLane>& lanePtr : lanes) {
+        RaceLane& lane = *lanePtr;
+        {
+            std::lock_guard<std::mutex> lock(lane.mutex);
+            cells.swap(lane.expanded);
+            lane.shown = lane.progress;
+        }
+        for (int cell : cells) {
+            lane.renderer->mark(cell, CELL_EXPLORED);
+        }
+        cells.clear();
+
+        // The engine no longer touches the path once it reported finishing
+        if (lane.shown.finished && !lane.pathDrawn) {
+            for (const Coordinates& p : lane.path) {
+                lane.renderer->mark(maze.index(p), CELL_FINAL_PATH);
+            }
+            lane.pathDrawn = true;
+        }
+        lane.renderer->flush(state);
+        allFinished = allFinished && lane.shown.finished;
+    }
+    return allFinished;
+}
+
+// One box per engine with nodes opened, time and path length side by side.
+// Among finished engines that found a path the best value of each column
+// is highlighted.
+void drawStats(const RaceLanes& lanes, const UIState& state, bool done) {
+    int max_x, max_y;
+    getmaxyx(stdscr, max_y, max_x);
+    int top = max_y - kStatsRows;
+    for (int y = top; y < max_y; y++) {
+        move(y, 0);
+        clrtoeol();
+    }
+
+    int fewestOpened = -1;
+    std::size_t shortestPath = 0;
+    double fastest = 0.0;
+    for (const std::unique_ptr<RaceLane>& lane : lanes) {
+        const LaneSnapshot& s = lane->shown;
+        if (s.finished && s.found) {
+            if (fewestOpened < 0 || s.openedNodes < fewestOpened) fewestOpened = s.openedNodes;
+            if (shortestPath == 0 || s.pathLength < shortestPath) shortestPath = s.pathLength;
+            if (fastest == 0.0 || s.searchMs < fastest) fastest = s.searchMs;
+        }
+    }
+
+    int count = static_cast<int>(lanes.size());
+    int box_spacing = 1;
+    int box_width = (max_x - (count + 1) * box_spacing) / count;
+
+    // Narrow boxes drop the labels and the gaps; the controls line names
+    // the rows instead
+    bool compact = box_width < 18;
+    if (compact) {
+        box_spacing = 0;
+        box_width = max_x / count;
+    }
+    int text_x = compact ? 1 : 2;
+    int text_width = box_width - text_x - 1;
+    int x = box_spacing;
+    for (const std::unique_ptr<RaceLane>& lane : lanes) {
+        const LaneSnapshot& s = lane->shown;
+        drawMenuBox(top, top + 5, x, x + box_width - 1);
+
+        attron(A_BOLD | COLOR_PAIR(3));
+        const std::string& name = static_cast<int>(lane->algorithm->name.size()) <= text_width
+            ? lane->algorithm->name : lane->algorithm->key;
+        printClipped(top + 1, x + text_x, text_width, "%s", name.c_str());
+        attroff(A_BOLD | COLOR_PAIR(3));
+
+        int best = COLOR_PAIR(5) | A_BOLD;
+        int normal = COLOR_PAIR(3);
+        int attr = s.found && s.openedNodes == fewestOpened ? best : normal;
+        attron(attr);
+        printClipped(top + 2, x + text_x, text_width, compact ? "%d" : "Opened: %d", s.openedNodes);
+        attroff(attr);
+
+        if (!s.finished) {
+            attron(COLOR_PAIR(7));
+            printClipped(top + 3, x + text_x, text_width, "%s", state.paused ? "Paused" : "Running");
+            attroff(COLOR_PAIR(7));
+            x += box_width + box_spacing;
+            continue;
+        }
+
+        attr = s.found && s.searchMs == fastest ? best : normal;
+        attron(attr);
+        printClipped(top + 3, x + text_x, text_width, compact ? "%.2fms" : "Time: %.2f ms", s.searchMs);
+        attroff(attr);
+
+        if (s.found) {
+            attr = s.pathLength == shortestPath ? best : normal;
+            attron(attr);
+            printClipped(top + 4, x + text_x, text_width, compact ? "%zu" : "Path: %zu", s.pathLength);
+            attroff(attr);
+        } else {
+            attron(COLOR_PAIR(6));
+            printClipped(top + 4, x + text_x, text_width, "%s", done ? "No path" : "Stopped");
+            attroff(COLOR_PAIR(6));
+        }
+        x += box_width + box_spacing;
+    }
+
+    attron(COLOR_PAIR(4));
+    if (done) {
+        mvprintw(max_y - 1, 2, "Controls: R=Restart, Q=Menu, WASD=Scroll");
+    } else {
+        mvprintw(max_y - 1, 2, "Controls: Q=Quit, P=Pause, R=Restart, Up/Down=Speed (%.3fs), WASD=Scroll",
+                 state.speed);
+    }
+    if (compact) {
+        printw("   Boxes: opened, time, path");
+    }
+    attroff(COLOR_PAIR(4));
+}
+
+void redrawRace(RaceLanes& lanes, UIState& state, bool done) {
+    clear();
+    layoutPanes(lanes);
+    for (std::unique_ptr<RaceLane>& lane : lanes) {
+        lane->renderer->redrawAll(state);
+        drawPaneFrame(*lane);
+    }
+    drawStats(lanes, state, done);
+    refresh();
+}
+
+void scrollPanes(RaceLanes& lanes, UIState& state, int key) {
+    scrollView(state, key);
+    for (std::unique_ptr<RaceLane>& lane : lanes) {
+        lane->renderer->invalidateView();
+        lane->renderer->flush(state);
+    }
+}
+
+bool isScrollKey(int ch) {
+    return ch == 'w' || ch == 'W' || ch == 'a' || ch == 'A' || ch == 's' || ch == 'S' || ch == 'd' || ch == 'D';
+}
+
+} // namespace
+
+void runRace(UIState& uiState) {
+    const std::vector<AlgorithmInfo>& algorithms = availableAlgorithms();
+
+    while (true) {
+        // All lanes share one cached maze prepared for every engine in the
+        // race, read-only, so restarting neither rereads the file nor
+        // prepares the maze again
+        const std::string& filename = uiState.files[uiState.current_file];
+        clear();
+        mvprintw(LINES/2, (COLS-17)/2, "Preparing maze...");
+        refresh();
+        RaceLanes lanes;
+        std::vector<const AlgorithmInfo*> engines;
+        for (std::size_t i = 0; i < algorithms.size(); ++i) {
+            if (uiState.race_selection[i]) {
+                std::unique_ptr<RaceLane> lane(new RaceLane());
+                lane->algorithm = &algorithms[i];
+                lanes.push_back(std::move(lane));
+                engines.push_back(&algorithms[i]);
+            }
+        }
+        std::shared_ptr<const CachedMaze> source = sharedMazeCache().load(filename, engines);
+        if (!source) {
+            clear();
+            mvprintw(LINES/2, (COLS-30)/2, "Error loading maze file!");
+            mvprintw(LINES/2+1, (COLS-30)/2, "Press any key to continue...");
+            refresh();
+            getch();
+            return;
+        }
+
+        clear();
+        drawHeader();
+        checkTerminalSize(uiState);
+        if (uiState.user_quit) {
+            uiState.user_quit = false;
+            return;
+        }
+
+        // Panes share one scroll position, so the view does not follow any single engine
+        uiState.running = true;
+        uiState.paused = false;
+        uiState.finished = false;
+        uiState.view_x = 0;
+        uiState.view_y = 0;
+        uiState.follow_frontier = false;
+
+        const Grid& maze = source->maze;
+        for (std::unique_ptr<RaceLane>& lane : lanes) {
+            lane->progress = LaneSnapshot();
+            lane->shown = LaneSnapshot();
+            lane->renderer.reset(new MazeRenderer(maze));
+            lane->pathDrawn = false;
+        }
+        redrawRace(lanes, uiState, false);
+
+        RaceControl control;
+        control.stop = false;
+        control.paused = false;
+        control.delayUs = static_cast<int>(uiState.speed * 1000000);
+
+        std::vector<std::thread> threads;
+        for (std::unique_ptr<RaceLane>& lane : lanes) {
+            threads.push_back(std::thread(runLane, std::cref(maze), std::cref(source->start), std::cref(source->end),
+                                          std::ref(*lane), std::ref(control)));
+        }
+
+        bool quit = false;
+        bool restart = false;
+        nodelay(stdscr, TRUE);
+        while (true) {
+            int ch;
+            while ((ch = getch()) != ERR) {
+                if (ch == 'q' || ch == 'Q') {
+                    quit = true;
+                } else if (ch == 'r' || ch == 'R') {
+                    restart = true;
+                } else if (ch == 'p' || ch == 'P') {
+                    uiState.paused = !uiState.paused;
+                    control.paused = uiState.paused;
+                } else if (ch == KEY_UP || ch == KEY_DOWN) {
+                    changeSpeed(uiState, ch == KEY_UP);
+                    control.delayUs = static_cast<int>(uiState.speed * 1000000);
+                } else if (isScrollKey(ch)) {
+                    scrollPanes(lanes, uiState, ch);
+                } else if (ch == KEY_RESIZE) {
+                    redrawRace(lanes, uiState, false);
+                }
+            }
+            if (quit || restart) {
+                control.stop = true;
+                break;
+            }
+
+            bool allFinished = pumpLanes(maze, lanes, uiState);
+            drawStats(lanes, uiState, false);
+            refresh();
+            if (allFinished) {
+                break;
+            }
+            usleep(static_cast<useconds_t>(kFrameInterval.count()));
+        }
+        nodelay(stdscr, FALSE);
+
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        uiState.running = false;
+        uiState.paused = false;
+        if (quit) {
+            return;
+        }
+        if (restart) {
+            continue;
+        }
+
+        // Results: panes stay on screen with every path drawn
+        uiState.finished = true;
+        pumpLanes(maze, lanes, uiState);
+        drawStats(lanes, uiState, true);
+        refresh();
+        while (true) {
+            int ch = getch();
+            if (ch == 'r' || ch == 'R') {
+                restart = true;
+                break;
+            } else if (ch == 'q' || ch == 'Q') {
+                return;
+            } else if (isScrollKey(ch)) {
+                scrollPanes(lanes, uiState, ch);
+                refresh();
+            } else if (ch == KEY_RESIZE) {
+                redrawRace(lanes, uiState, true);
+            }
+        }
+    }
+}
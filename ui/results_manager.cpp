@@ -1,8 +1,21 @@
 #include "../include/results_manager.h"
 #include "../include/ui_functions.h"
+#include <algorithm>
+#include <cstdio>
 #include <ncurses.h>
 
-bool showFinalResults(const Matrix& maze, bool pathFound, const std::vector<Coordinates>& path, int openedNodes, UIState& uiState) {
+namespace {
+
+std::string formatMs(double ms) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.2f", ms);
+    return text;
+}
+
+} // namespace
+
+bool showFinalResults(MazeRenderer& renderer, bool pathFound, const std::vector<Coordinates>& path, int openedNodes, UIState& uiState,
+                      const BaselineComparison* comparison, const RunMemory* memory, int shortestLength) {
     int max_x, max_y;
     getmaxyx(stdscr, max_y, max_x);
     
@@ -14,7 +27,7 @@ bool showFinalResults(const Matrix& maze, bool pathFound, const std::vector<Coor
                 mvprintw(y, x, " ");
             }
         }
-        int num_boxes = 2;
+        int num_boxes = comparison != nullptr ? 3 : 2;
         int box_spacing = 1;
         int total_spacing = (num_boxes + 1) * box_spacing;
         int base_box_width = (max_x - total_spacing) / num_boxes;
@@ -34,18 +47,54 @@ bool showFinalResults(const Matrix& maze, bool pathFound, const std::vector<Coor
         x += status_box_width + box_spacing;
         
         // Path length box (only if path found)
-        int path_box_width = base_box_width + remainder;
+        int path_box_width = comparison != nullptr ? base_box_width : base_box_width + remainder;
         drawMenuBox(result_y, result_y + 2, x, x + path_box_width);
         attron(COLOR_PAIR(5));
-        if (pathFound) {
+        if (pathFound && shortestLength > 0) {
+            // How far the engine's path is from a shortest one
+            std::string text = "Length: " + std::to_string(path.size()) + " nodes" +
+                               (path.size() == static_cast<std::size_t>(shortestLength)
+                                    ? std::string(" (shortest)")
+                                    : " (shortest " + std::to_string(shortestLength) + ")");
+            mvprintw(result_y + 1, x + 2, "%.*s", std::max(path_box_width - 3, 0), text.c_str());
+        } else if (pathFound) {
             mvprintw(result_y + 1, x + 2, "Length: %zu nodes", path.size());
         } else {
             mvprintw(result_y + 1, x + 2, "Explored: %d", openedNodes);
         }
         attroff(COLOR_PAIR(5));
+        x += path_box_width + box_spacing;
+
+        // Nodes and time saved over the baseline engine, clipped to the box
+        if (comparison != nullptr) {
+            int compare_box_width = base_box_width + remainder;
+            drawMenuBox(result_y, result_y + 2, x, x + compare_box_width);
+            const BaselineComparison& c = *comparison;
+            long long saved = c.baselineOpenedNodes > 0
+                ? (c.baselineOpenedNodes - c.openedNodes) * 100LL / c.baselineOpenedNodes : 0;
+            attron(COLOR_PAIR(5));
+            std::string text = "vs " + c.baseline + ": " + std::to_string(saved >= 0 ? saved : -saved) +
+                               (saved >= 0 ? "% fewer nodes, " : "% more nodes, ") + formatMs(c.solveMs) + " vs " +
+                               formatMs(c.baselineSolveMs) + " ms";
+            mvprintw(result_y + 1, x + 2, "%.*s", std::max(compare_box_width - 3, 0), text.c_str());
+            attroff(COLOR_PAIR(5));
+        }
         
+        // Memory of the run, between the status boxes and the controls
+        if (memory != nullptr) {
+            const RunMemory& m = *memory;
+            std::string text = "Memory: parents " + formatBytes(m.parents.peakBytes) + ", frontier " +
+                               formatBytes(m.frontier.peakBytes) + " (peak " + std::to_string(m.peakFrontier) +
+                               " cells), path " + formatBytes(m.path.bytes) + ", maze " + formatBytes(m.maze.bytes) +
+                               ", " + std::to_string(m.parents.allocations + m.frontier.allocations) +
+                               " allocations";
+            attron(COLOR_PAIR(4));
+            mvprintw(max_y - 2, 2, "%.*s", std::max(max_x - 4, 0), text.c_str());
+            attroff(COLOR_PAIR(4));
+        }
+
         attron(COLOR_PAIR(4));
-        mvprintw(max_y - 1, 2, "Controls: R=Restart, Q=Menu, Up/Down=Speed");
+        mvprintw(max_y - 1, 2, "Controls: R=Restart, Q=Menu, E=Edit walls, Up/Down=Speed, WASD=Scroll");
         attroff(COLOR_PAIR(4));
         refresh();
     };
@@ -59,45 +108,27 @@ bool showFinalResults(const Matrix& maze, bool pathFound, const std::vector<Coor
             return true;
         } else if (ch == 'q' || ch == 'Q') {
             return false;
+        } else if (ch == 'e' || ch == 'E') {
+            uiState.edit_requested = true;
+            return true;
         } else if (ch == KEY_RESIZE) {
             clear();
             drawHeader();
-            drawFinalInfo();
-            drawMaze(maze, uiState);
-            updateStatus(uiState);
-            refresh();
-        } else if (ch == KEY_UP) {
-            // Speed up with fixed steps
-            if (uiState.speed > 0.001) {
-                if (uiState.speed <= 0.001) uiState.speed = 0.001;
-                else if (uiState.speed <= 0.0025) uiState.speed = 0.001;
-                else if (uiState.speed <= 0.005) uiState.speed = 0.0025;
-                else if (uiState.speed <= 0.01) uiState.speed = 0.005;
-                else if (uiState.speed <= 0.025) uiState.speed = 0.01;
-                else if (uiState.speed <= 0.05) uiState.speed = 0.025;
-                else if (uiState.speed <= 0.1) uiState.speed = 0.05;
-                else if (uiState.speed <= 0.2) uiState.speed = 0.1;
-                else if (uiState.speed <= 0.5) uiState.speed = 0.2;
-                else uiState.speed = 0.5;
-            }
+            renderer.redrawAll(uiState);
+            // The status boxes clear the rows the memory line is on
             updateStatus(uiState);
-            refresh();
-        } else if (ch == KEY_DOWN) {
-            // Slow down with fixed steps
-            if (uiState.speed < 1.0) {
-                if (uiState.speed >= 1.0) uiState.speed = 1.0;
-                else if (uiState.speed >= 0.5) uiState.speed = 0.5;
-                else if (uiState.speed >= 0.2) uiState.speed = 0.5;
-                else if (uiState.speed >= 0.1) uiState.speed = 0.2;
-                else if (uiState.speed >= 0.05) uiState.speed = 0.1;
-                else if (uiState.speed >= 0.025) uiState.speed = 0.05;
-                else if (uiState.speed >= 0.01) uiState.speed = 0.025;
-                else if (uiState.speed >= 0.005) uiState.speed = 0.01;
-                else if (uiState.speed >= 0.0025) uiState.speed = 0.005;
-                else uiState.speed = 0.0025;
-            }
+            drawFinalInfo();
+        } else if (ch == 'w' || ch == 'W' || ch == 'a' || ch == 'A' ||
+                   ch == 's' || ch == 'S' || ch == 'd' || ch == 'D') {
+            // Scroll around the finished search
+            scrollView(uiState, ch);
+            renderer.invalidateView();
+            renderer.flush(uiState);
+            drawFinalInfo();
+        } else if (ch == KEY_UP || ch == KEY_DOWN) {
+            changeSpeed(uiState, ch == KEY_UP);
             updateStatus(uiState);
-            refresh();
+            drawFinalInfo();
         }
         // For any other key, stay on the results screen
     }
@@ -0,0 +1,294 @@
+#include "../include/trace_player.h"
+#include "../include/maze_renderer.h"
+#include "../include/ui_functions.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <ncurses.h>
+#include <unistd.h>
+
+namespace {
+
+// Screen repaints per second while playing
+const std::chrono::microseconds kFrameInterval(1000000 / 60);
+
+// Playback rates, in trace cells per second
+const double kMinRate = 1.0;
+const double kMaxRate = 1e9;
+
+// The trace drawn into a renderer up to the current frame
+class TracePlayer {
+public:
+    TracePlayer(const Grid& maze, const SearchTrace& trace, MazeRenderer& renderer)
+        : trace_(trace), renderer_(renderer), frame_(0) {
+        // The marker each cell had before its event, so undoing an event
+        // is one mark() however the cell was drawn before
+        std::size_t frames = this->frames();
+        before_.resize(frames);
+        std::vector<std::int8_t> marks(maze.cellCount(), CELL_PATH);
+        for (std::size_t event = 0; event < frames; ++event) {
+            int cell = cellOf(event);
+            before_[event] = marks[cell];
+            marks[cell] = static_cast<std::int8_t>(kindOf(event));
+        }
+    }
+
+    std::size_t frame() const { return frame_; }
+    std::size_t frames() const { return trace_.expanded.size() + trace_.path.size(); }
+
+    /// Opened cells shown at the current frame
+    int openedShown() const { return static_cast<int>(std::min(frame_, trace_.expanded.size())); }
+
+    /// Cell of the last event shown, or -1 at frame 0
+    int lastCell() const { return frame_ > 0 ? cellOf(frame_ - 1) : -1; }
+
+    void seek(std::size_t target) {
+        target = std::min(target, frames());
+        // Far back is cheaper redrawn from the start than undone
+        if (target < frame_ && frame_ - target > target) {
+            renderer_.clearMarks();
+            frame_ = 0;
+        }
+        for (; frame_ < target; ++frame_) {
+            renderer_.mark(cellOf(frame_), kindOf(frame_));
+        }
+        for (; frame_ > target; --frame_) {
+            renderer_.mark(cellOf(frame_ - 1), before_[frame_ - 1]);
+        }
+    }
+
+private:
+    int cellOf(std::size_t event) const {
+        std::size_t opened = trace_.expanded.size();
+        return event < opened ? trace_.expanded[event] : trace_.path[event - opened];
+    }
+
+    int kindOf(std::size_t event) const {
+        return event < trace_.expanded.size() ? CELL_EXPLORED : CELL_FINAL_PATH;
+    }
+
+    const SearchTrace& trace_;
+    MazeRenderer& renderer_;
+    std::vector<std::int8_t> before_;
+    std::size_t frame_;
+};
+
+// Status boxes, then the playback line and the controls below them
+void drawPlayerStatus(const TracePlayer& player, const SearchTrace& trace, UIState& state, double rate) {
+    state.opened_nodes = player.openedShown();
+    updateStatus(state);
+
+    int max_x, max_y;
+    getmaxyx(stdscr, max_y, max_x);
+    double percent = player.frames() > 0 ? player.frame() * 100.0 / player.frames() : 100.0;
+    const char* mode = state.finished ? "END" : state.paused ? "PAUSED" : "PLAYING";
+    std::string text = "Replay " + trace.algorithm + ": frame " + std::to_string(player.frame()) + " / " +
+                       std::to_string(player.frames()) + " (" + std::to_string(static_cast<int>(percent)) + "%), " +
+                       std::to_string(static_cast<long long>(rate)) + " cells/s, " +
+                       (trace.found ? "path " + std::to_string(trace.path.size()) : std::string("no path")) +
+                       "  " + mode;
+    for (int x = 0; x < max_x; ++x) {
+        mvaddch(max_y - 2, x, ' ');
+        mvaddch(max_y - 1, x, ' ');
+    }
+    attron(COLOR_PAIR(5));
+    mvprintw(max_y - 2, 2, "%.*s", std::max(max_x - 4, 0), text.c_str());
+    attroff(COLOR_PAIR(5));
+    attron(COLOR_PAIR(4));
+    mvprintw(max_y - 1, 2, "%.*s", std::max(max_x - 4, 0),
+             "Controls: Space=Play/Pause, Left/Right=Step, [/]=Seek, 0-9=Jump, Up/Down=Speed, R=Replay, "
+             "WASD=Scroll, F=Follow, Q=Menu");
+    attroff(COLOR_PAIR(4));
+}
+
+} // namespace
+
+void playTrace(const Grid& maze, const SearchTrace& trace, UIState& uiState) {
+    MazeRenderer renderer(maze);
+    TracePlayer player(maze, trace, renderer);
+
+    // Start at a power of two that plays the whole trace in about ten seconds
+    double rate = kMinRate;
+    while (rate * 2 * 10 <= player.frames() && rate < kMaxRate) {
+        rate *= 2;
+    }
+
+    // The speed box shows seconds per cell, so the menu's speed is put back
+    // on the way out
+    double menuSpeed = uiState.speed;
+    uiState.running = true;
+    uiState.paused = false;
+    uiState.finished = player.frames() == 0;
+    uiState.view_x = 0;
+    uiState.view_y = 0;
+    uiState.follow_frontier = true;
+    uiState.speed = 1.0 / rate;
+
+    clear();
+    drawHeader();
+    renderer.redrawAll(uiState);
+    drawPlayerStatus(player, trace, uiState, rate);
+    refresh();
+
+    std::chrono::steady_clock::time_point last = std::chrono::steady_clock::now();
+    double due = 0.0;   // Cells owed to the playback clock, carried between frames
+    nodelay(stdscr, TRUE);
+    while (true) {
+        std::size_t before = player.frame();
+        bool quit = false;
+        bool redraw = false;
+        int ch;
+        while ((ch = getch()) != ERR) {
+            bool stepped = true;
+            switch (ch) {
+                case 'q': case 'Q':
+                    quit = true;
+                    break;
+                case ' ': case 'p': case 'P':
+                    if (uiState.finished) {
+                        player.seek(0);
+                    }
+                    uiState.paused = !uiState.paused && !uiState.finished;
+                    stepped = false;
+                    break;
+                case 'r': case 'R':
+                    player.seek(0);
+                    uiState.paused = false;
+                    break;
+                case KEY_RIGHT:
+                    uiState.paused = true;
+                    player.seek(player.frame() + 1);
+                    break;
+                case KEY_LEFT:
+                    uiState.paused = true;
+                    player.seek(player.frame() > 0 ? player.frame() - 1 : 0);
+                    break;
+                case ']': case KEY_NPAGE:
+                    player.seek(player.frame() + std::max<std::size_t>(player.frames() / 20, 1));
+                    break;
+                case '[': case KEY_PPAGE: {
+                    std::size_t step = std::max<std::size_t>(player.frames() / 20, 1);
+                    player.seek(player.frame() > step ? player.frame() - step : 0);
+                    break;
+                }
+                case KEY_HOME:
+                    player.seek(0);
+                    break;
+                case KEY_END:
+                    player.seek(player.frames());
+                    break;
+                case KEY_UP:
+                    rate = std::min(rate * 2, kMaxRate);
+                    stepped = false;
+                    break;
+                case KEY_DOWN:
+                    rate = std::max(rate / 2, kMinRate);
+                    stepped = false;
+                    break;
+                case 'f': case 'F':
+                    uiState.follow_frontier = !uiState.follow_frontier;
+                    stepped = false;
+                    break;
+                case KEY_RESIZE:
+                    redraw = true;
+                    stepped = false;
+                    break;
+                default:
+                    stepped = false;
+                    if (ch == 'w' || ch == 'W' || ch == 'a' || ch == 'A' ||
+                        ch == 's' || ch == 'S' || ch == 'd' || ch == 'D') {
+                        scrollView(uiState, ch);
+                        renderer.invalidateView();
+                    } else if (ch >= '0' && ch <= '9') {
+                        player.seek(player.frames() * (ch - '0') / 10);
+                        stepped = true;
+                    }
+                    break;
+            }
+            if (stepped) {
+                due = 0.0;
+            }
+        }
+        if (quit) {
+            break;
+        }
+
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        double elapsed = std::chrono::duration<double>(now - last).count();
+        last = now;
+        if (!uiState.paused && player.frame() < player.frames()) {
+            due += rate * elapsed;
+            std::size_t steps = static_cast<std::size_t>(std::min(due, static_cast<double>(player.frames())));
+            due -= static_cast<double>(steps);
+            player.seek(player.frame() + steps);
+        }
+        uiState.finished = player.frame() == player.frames();
+        uiState.running = !uiState.paused && !uiState.finished;
+        uiState.speed = 1.0 / rate;
+
+        if (player.frame() != before && uiState.follow_frontier && player.lastCell() >= 0) {
+            renderer.follow(uiState, player.lastCell());
+        }
+        if (redraw) {
+            clear();
+            drawHeader();
+            renderer.redrawAll(uiState);
+        } else {
+            renderer.flush(uiState);
+        }
+        drawPlayerStatus(player, trace, uiState, rate);
+        refresh();
+        usleep(static_cast<useconds_t>(kFrameInterval.count()));
+    }
+    nodelay(stdscr, FALSE);
+
+    uiState.speed = menuSpeed;
+    uiState.running = false;
+    uiState.paused = false;
+    uiState.finished = false;
+}
+
+void runReplay(UIState& uiState) {
+    const AlgorithmInfo& algorithm = availableAlgorithms()[uiState.current_algorithm];
+    const std::string& filename = uiState.files[uiState.current_file];
+    std::shared_ptr<const CachedMaze> source = sharedMazeCache().load(filename, &algorithm);
+    if (!source) {
+        clear();
+        mvprintw(LINES/2, (COLS-30)/2, "Error loading maze file!");
+        mvprintw(LINES/2+1, (COLS-30)/2, "Press any key to continue...");
+        refresh();
+        getch();
+        return;
+    }
+
+    clear();
+    drawHeader();
+    checkTerminalSize(uiState);
+    if (uiState.user_quit) {
+        uiState.user_quit = false;
+        return;
+    }
+    std::string message = "Recording " + algorithm.name + "...";
+    mvprintw(LINES/2, std::max((COLS - static_cast<int>(message.size())) / 2, 0), "%s", message.c_str());
+    refresh();
+
+    SearchWorkspace workspace;
+    SearchTrace trace = recordSearch(algorithm, source->maze, filename, source->start, source->end, workspace);
+    playTrace(source->maze, trace, uiState);
+}
+
+bool openTrace(const std::string& filename, SearchTrace& trace, std::shared_ptr<const CachedMaze>& maze) {
+    if (!readTrace(filename, trace)) {
+        return false;
+    }
+    maze = sharedMazeCache().load(trace.mazeFile);
+    if (!maze) {
+        return false;
+    }
+    if (!traceMatches(trace, maze->maze)) {
+        std::cerr << "Error: " << trace.mazeFile << " has changed since " << filename << " was recorded" << std::endl;
+        maze.reset();
+        return false;
+    }
+    return true;
+}
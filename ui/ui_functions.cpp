@@ -1,5 +1,6 @@
 #include "../include/ui_functions.h"
 #include "../include/ui_state.h"
+#include "../include/maze_renderer.h"
 #include <ncurses.h>
 #include <unistd.h>
 #include <sys/ioctl.h>
@@ -7,6 +8,7 @@
 #include <cstdlib>
 #include <string>
 #include <algorithm>
+#include <tuple>
 
 void initColors() {
     if (has_colors()) {
@@ -38,69 +40,92 @@ void drawHeader() {
     attroff(A_BOLD | COLOR_PAIR(1));
 }
 
-void drawMaze(const Matrix& maze, const UIState& /* state */) {
-    drawHeader();
+void drawMazeCell(int screen_y, int screen_x, int cell) {
+    char symbol;
+    int color = 0;
+    
+    switch (cell) {
+        case 0:  // Path
+            symbol = ' ';
+            break;
+        case 1:  // Wall
+            symbol = '#';
+            color = 9;
+            break;
+        case 2:  // Final path
+            symbol = '*';
+            color = 5;
+            break;
+        case 3:  // Explored
+            symbol = '.';
+            color = 7;
+            break;
+        case -1: // Start
+            symbol = 'S';
+            color = 5;
+            break;
+        case -2: // End
+            symbol = 'E';
+            color = 6;
+            break;
+        default:
+            symbol = '?';
+            break;
+    }
+    
+    mvaddch(screen_y, screen_x, static_cast<chtype>(symbol) | (color ? COLOR_PAIR(color) : 0));
+}
+
+ScreenArea mazeArea() {
     int max_x, max_y;
     getmaxyx(stdscr, max_y, max_x);
     
-    // Calculate maze display position (centered)
-    int maze_height = static_cast<int>(maze.size());
-    int maze_width = static_cast<int>(maze[0].size());
-    int start_y = (max_y - maze_height) / 2;
-    int start_x = (max_x - maze_width) / 2;
+    // Between the header and the status boxes, one column from each edge
+    ScreenArea area = {2, 1, max_y - 8, max_x - 2};
+    return area;
+}
+
+MazeLayout mazeLayout(const Grid& maze, const ScreenArea& area) {
+    MazeLayout layout = {};
+    layout.block = 1;
     
-    // Clear maze area
-    for (int y = 0; y < maze_height; y++) {
-        for (int x = 0; x < maze_width; x++) {
-            mvprintw(start_y + y, start_x + x, " ");
-        }
+    // Mazes that fit the area are drawn whole and centered
+    if (maze.height() <= area.rows && maze.width() <= area.cols) {
+        layout.rows = maze.height();
+        layout.cols = maze.width();
+        layout.top = area.top + (area.rows - maze.height()) / 2;
+        layout.left = area.left + (area.cols - maze.width()) / 2;
+        return layout;
     }
     
-    // Draw maze with appropriate symbols and colors
-    for (int y = 0; y < maze_height; y++) {
-        for (int x = 0; x < maze_width; x++) {
-            int cell = maze[y][x];
-            char symbol;
-            
-            switch (cell) {
-                case 0:  // Path
-                    symbol = ' ';
-                    break;
-                case 1:  // Wall
-                    symbol = '#';
-                    attron(COLOR_PAIR(9));
-                    break;
-                case 2:  // Final path
-                    symbol = '*';
-                    attron(COLOR_PAIR(5));
-                    break;
-                case 3:  // Explored
-                    symbol = '.';
-                    attron(COLOR_PAIR(7));
-                    break;
-                case -1: // Start
-                    symbol = 'S';
-                    attron(COLOR_PAIR(5));
-                    break;
-                case -2: // End
-                    symbol = 'E';
-                    attron(COLOR_PAIR(6));
-                    break;
-                default:
-                    symbol = '?';
-                    break;
-            }
-            
-            mvprintw(start_y + y, start_x + x, "%c", symbol);
-            
-            // Reset all color attributes
-            attroff(COLOR_PAIR(1));
-            attroff(COLOR_PAIR(5));
-            attroff(COLOR_PAIR(6));
-            attroff(COLOR_PAIR(7));
-            attroff(COLOR_PAIR(9));
-        }
+    // Otherwise a window of the maze fills the area from its top-left corner
+    layout.scrolled = true;
+    layout.top = area.top;
+    layout.left = area.left;
+    int map_cols = area.cols;
+    
+    // Minimap gets up to a quarter of the width, inside a box
+    int minimap_width = area.cols / 4 - 2;
+    int minimap_height = area.rows - 2;
+    if (minimap_width >= 8 && minimap_height >= 4) {
+        int block = std::max((maze.width() + minimap_width - 1) / minimap_width,
+                             (maze.height() + minimap_height - 1) / minimap_height);
+        layout.block = std::max(block, 1);
+        layout.minimap_cols = (maze.width() + layout.block - 1) / layout.block;
+        layout.minimap_rows = (maze.height() + layout.block - 1) / layout.block;
+        layout.minimap_top = area.top + 1;
+        layout.minimap_left = area.left + area.cols - 1 - layout.minimap_cols;
+        map_cols = layout.minimap_left - 2 - area.left;
     }
+    
+    layout.rows = std::min(maze.height(), area.rows);
+    layout.cols = std::min(maze.width(), map_cols);
+    return layout;
+}
+
+void clampView(const Grid& maze, const MazeLayout& layout, UIState& state) {
+    state.view_x = std::max(0, std::min(state.view_x, maze.width() - layout.cols));
+    state.view_y = std::max(0, std::min(state.view_y, maze.height() - layout.rows));
 }
 
 void updateStatus(const UIState& state) {
@@ -174,10 +199,53 @@ void updateStatus(const UIState& state) {
     
     // Controls at the very bottom
     attron(COLOR_PAIR(4));
-    mvprintw(max_y - 1, 2, "Controls: Q=Quit, P=Pause, R=Restart, Up/Down=Speed");
+    mvprintw(max_y - 1, 2, "Controls: Q=Quit, P=Pause, R=Restart, Up/Down=Speed, WASD=Scroll, F=Follow");
     attroff(COLOR_PAIR(4));
 }
 
+// Step the animation speed up or down through fixed delays
+void changeSpeed(UIState& state, bool faster) {
+    if (faster) {
+        if (state.speed > 0.001) {
+            if (state.speed <= 0.001) state.speed = 0.001;
+            else if (state.speed <= 0.0025) state.speed = 0.001;
+            else if (state.speed <= 0.005) state.speed = 0.0025;
+            else if (state.speed <= 0.01) state.speed = 0.005;
+            else if (state.speed <= 0.025) state.speed = 0.01;
+            else if (state.speed <= 0.05) state.speed = 0.025;
+            else if (state.speed <= 0.1) state.speed = 0.05;
+            else if (state.speed <= 0.2) state.speed = 0.1;
+            else if (state.speed <= 0.5) state.speed = 0.2;
+            else state.speed = 0.5;
+        }
+    } else {
+        if (state.speed < 1.0) {
+            if (state.speed >= 1.0) state.speed = 1.0;
+            else if (state.speed >= 0.5) state.speed = 0.5;
+            else if (state.speed >= 0.2) state.speed = 0.5;
+            else if (state.speed >= 0.1) state.speed = 0.2;
+            else if (state.speed >= 0.05) state.speed = 0.1;
+            else if (state.speed >= 0.025) state.speed = 0.05;
+            else if (state.speed >= 0.01) state.speed = 0.025;
+            else if (state.speed >= 0.005) state.speed = 0.01;
+            else if (state.speed >= 0.0025) state.speed = 0.005;
+            else state.speed = 0.0025;
+        }
+    }
+}
+
+// Manual scrolling stops the view from following the search
+void scrollView(UIState& state, int key) {
+    const int step = 8;
+    switch (key) {
+        case 'w': case 'W': state.view_y -= step; break;
+        case 's': case 'S': state.view_y += step; break;
+        case 'a': case 'A': state.view_x -= step; break;
+        case 'd': case 'D': state.view_x += step; break;
+    }
+    state.follow_frontier = false;
+}
+
 int handleInput(UIState& state) {
     nodelay(stdscr, TRUE);
     int ch = getch();
@@ -206,37 +274,23 @@ int handleInput(UIState& state) {
             updateStatus(state);
             refresh();
             break;
+        case 'w':
+        case 'W':
+        case 'a':
+        case 'A':
+        case 's':
+        case 'S':
+        case 'd':
+        case 'D':
+            scrollView(state, ch);
+            return 3;  // View moved
+        case 'f':
+        case 'F':
+            state.follow_frontier = !state.follow_frontier;
+            return 3;
         case KEY_UP:
-            // Speed up with fixed steps
-            if (state.speed > 0.001) {
-                if (state.speed <= 0.001) state.speed = 0.001;
-                else if (state.speed <= 0.0025) state.speed = 0.001;
-                else if (state.speed <= 0.005) state.speed = 0.0025;
-                else if (state.speed <= 0.01) state.speed = 0.005;
-                else if (state.speed <= 0.025) state.speed = 0.01;
-                else if (state.speed <= 0.05) state.speed = 0.025;
-                else if (state.speed <= 0.1) state.speed = 0.05;
-                else if (state.speed <= 0.2) state.speed = 0.1;
-                else if (state.speed <= 0.5) state.speed = 0.2;
-                else state.speed = 0.5;
-            }
-            updateStatus(state);
-            refresh();
-            break;
         case KEY_DOWN:
-            // Slow down with fixed steps
-            if (state.speed < 1.0) {
-                if (state.speed >= 1.0) state.speed = 1.0;
-                else if (state.speed >= 0.5) state.speed = 0.5;
-                else if (state.speed >= 0.2) state.speed = 0.5;
-                else if (state.speed >= 0.1) state.speed = 0.2;
-                else if (state.speed >= 0.05) state.speed = 0.1;
-                else if (state.speed >= 0.025) state.speed = 0.05;
-                else if (state.speed >= 0.01) state.speed = 0.025;
-                else if (state.speed >= 0.005) state.speed = 0.01;
-                else if (state.speed >= 0.0025) state.speed = 0.005;
-                else state.speed = 0.0025;
-            }
+            changeSpeed(state, ch == KEY_UP);
             updateStatus(state);
             refresh();
             break;
@@ -245,7 +299,7 @@ int handleInput(UIState& state) {
     return 1;  // Continue
 }
 
-void handleInputDuringDelay(UIState& state, const Matrix& maze, double delay) {
+void handleInputDuringDelay(UIState& state, MazeRenderer& renderer, double delay) {
     if (delay <= 0) return;
     
     int delay_us = static_cast<int>(delay * 1000000);  // Convert to microseconds
@@ -261,7 +315,13 @@ void handleInputDuringDelay(UIState& state, const Matrix& maze, double delay) {
         }
         if (inputResult == 2) {
             // Redraw maze and status on resize
-            drawMaze(maze, state);
+            renderer.redrawAll(state);
+            updateStatus(state);
+            refresh();
+        }
+        if (inputResult == 3) {
+            renderer.invalidateView();
+            renderer.flush(state);
             updateStatus(state);
             refresh();
         }
@@ -294,15 +354,14 @@ void drawMenuBox(int start_y, int end_y, int start_x, int end_x) {
 }
 
 
-void checkTerminalSize(const Matrix& maze, UIState& state) {
+void checkTerminalSize(UIState& state) {
     struct winsize w;
     int terminal_height, terminal_width;
-    int maze_height = static_cast<int>(maze.size());
-    int maze_width = static_cast<int>(maze[0].size());
     
-    // Required space for UI elements (header + status + padding)
-    const int required_height = maze_height + 10;
-    const int required_width = maze_width + 10;
+    // Mazes larger than the terminal are scrolled, so only the UI
+    // elements (header, status boxes and a usable map area) need to fit
+    const int required_height = 24;
+    const int required_width = 80;
     
     while (true) {
         if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &w) == 0) {
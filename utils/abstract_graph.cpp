@@ -0,0 +1,391 @@
+#include "../include/abstract_graph.h"
+#include "../include/parallel.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+
+namespace {
+
+// Entrances at least this long get a transition at each end instead of
+// one in the middle, as in Botea et al.'s HPA*
+const int kLongEntrance = 6;
+
+// Clusters linked by one task of the parallel build; each block collects
+// its edges apart, and blocks are joined in order so the graph does not
+// depend on the thread count
+const int kClustersPerBlock = 256;
+
+const char kGraphMagic[4] = {'H', 'P', 'A', '\0'};
+const std::uint32_t kGraphVersion = 1;
+
+struct GraphFileHeader {
+    char magic[4];              ///< kGraphMagic
+    std::uint32_t version;      ///< kGraphVersion
+    std::uint32_t width;
+    std::uint32_t height;
+    std::uint32_t clusterSize;
+    std::uint32_t nodeCount;
+    std::uint64_t edgeCount;
+    std::uint64_t contentHash;  ///< hashWalls() of the maze the graph was built for
+};
+
+struct ClusterEdge {
+    int from, to, cost;
+};
+
+// BFS within one cluster in its own row-major coordinates. load() reads
+// the cluster's open masks once, with moves across its bounds cleared, so
+// the floods from each of its transitions need no coordinate conversions
+// and reuse the same buffers.
+class LocalFlood {
+public:
+    void load(const Grid& maze, const ClusterBounds& area) {
+        width_ = area.width();
+        open_.resize(area.cellCount());
+        for (int y = area.y0; y < area.y1; ++y) {
+            for (int x = area.x0; x < area.x1; ++x) {
+                unsigned mask = maze.openMask(maze.index(x, y));
+                if (x == area.x0) mask &= ~1u;
+                if (x == area.x1 - 1) mask &= ~2u;
+                if (y == area.y0) mask &= ~4u;
+                if (y == area.y1 - 1) mask &= ~8u;
+                open_[area.local(Coordinates(x, y))] = static_cast<std::uint8_t>(mask);
+            }
+        }
+        distances_.resize(open_.size());
+        queue_.resize(open_.size());
+    }
+
+    /// Moves from local cell source to every cell of the cluster, or -1
+    const std::vector<int>& run(int source) {
+        const int offsets[4] = {-1, 1, -width_, width_};
+        std::fill(distances_.begin(), distances_.end(), -1);
+        distances_[source] = 0;
+        queue_[0] = source;
+        for (int head = 0, tail = 1; head < tail; ++head) {
+            int current = queue_[head];
+            unsigned open = open_[current];
+            for (int d = 0; d < 4; ++d) {
+                int next = current + offsets[d];
+                if ((open & (1u << d)) && distances_[next] < 0) {
+                    distances_[next] = distances_[current] + 1;
+                    queue_[tail++] = next;
+                }
+            }
+        }
+        return distances_;
+    }
+
+private:
+    int width_ = 0;
+    std::vector<std::uint8_t> open_;
+    std::vector<int> distances_;
+    std::vector<int> queue_;
+};
+
+bool readInts(std::FILE* file, std::vector<int>& values, std::size_t count) {
+    values.resize(count);
+    return count == 0 || std::fread(values.data(), sizeof(int), count, file) == count;
+}
+
+bool writeInts(std::FILE* file, const std::vector<int>& values) {
+    return values.empty() || std::fwrite(values.data(), sizeof(int), values.size(), file) == values.size();
+}
+
+} // namespace
+
+int floodCluster(const Grid& maze, const ClusterBounds& bounds, int sourceId, std::vector<int>& distances,
+                 std::vector<std::uint8_t>* parents, int stopId) {
+    distances.assign(bounds.cellCount(), -1);
+    if (parents != nullptr) {
+        parents->resize(bounds.cellCount());
+    }
+    std::vector<int> queue;
+    queue.reserve(bounds.cellCount());
+    queue.push_back(sourceId);
+    distances[bounds.local(maze.coordinates(sourceId))] = 0;
+
+    int expanded = 0;
+    for (std::size_t head = 0; head < queue.size(); ++head) {
+        int current = queue[head];
+        ++expanded;
+        if (current == stopId) {
+            break;
+        }
+        Coordinates c = maze.coordinates(current);
+        int next = distances[bounds.local(c)] + 1;
+        unsigned open = maze.openMask(current);
+        for (int d = 0; d < 4; ++d) {
+            Coordinates n(c.first + directions[d].first, c.second + directions[d].second);
+            if (!(open & (1u << d)) || !bounds.contains(n)) {
+                continue;
+            }
+            int local = bounds.local(n);
+            if (distances[local] >= 0) {
+                continue;
+            }
+            distances[local] = next;
+            if (parents != nullptr) {
+                (*parents)[local] = static_cast<std::uint8_t>(d);
+            }
+            queue.push_back(current + maze.offset(d));
+        }
+    }
+    return expanded;
+}
+
+AbstractGraph::AbstractGraph(const Grid& maze, int clusterSize)
+    : clusterSize_(clusterSize),
+      clustersX_((maze.width() + clusterSize - 1) / clusterSize),
+      clustersY_((maze.height() + clusterSize - 1) / clusterSize),
+      width_(maze.width()),
+      height_(maze.height()) {
+    std::vector<int> from, to, costs;
+    addEntrances(maze, from, to, costs);
+    indexNodes(maze);
+
+    // Shortest distances between the transitions of each cluster. Clusters
+    // are independent, so blocks of them are linked in parallel.
+    const int clusters = clustersX_ * clustersY_;
+    const int blocks = (clusters + kClustersPerBlock - 1) / kClustersPerBlock;
+    std::vector<std::vector<ClusterEdge>> blockEdges(blocks);
+    parallelForRanges(blocks, 1, [&](int firstBlock, int lastBlock) {
+        LocalFlood flood;
+        std::vector<int> locals;
+        for (int block = firstBlock; block < lastBlock; ++block) {
+            int lastCluster = std::min(clusters, (block + 1) * kClustersPerBlock);
+            for (int cluster = block * kClustersPerBlock; cluster < lastCluster; ++cluster) {
+                const int* first = clusterNodesBegin(cluster);
+                const int* last = clusterNodesEnd(cluster);
+                if (last - first < 2) {
+                    continue;
+                }
+                ClusterBounds area = bounds(cluster);
+                flood.load(maze, area);
+                locals.clear();
+                for (const int* v = first; v != last; ++v) {
+                    locals.push_back(area.local(maze.coordinates(nodeCells_[*v])));
+                }
+                for (const int* u = first; u != last; ++u) {
+                    const std::vector<int>& distances = flood.run(locals[u - first]);
+                    for (const int* v = first; v != last; ++v) {
+                        int distance = distances[locals[v - first]];
+                        if (v != u && distance > 0) {
+                            blockEdges[block].push_back(ClusterEdge{*u, *v, distance});
+                        }
+                    }
+                }
+            }
+        }
+    });
+    for (std::vector<ClusterEdge>& edges : blockEdges) {
+        for (const ClusterEdge& edge : edges) {
+            from.push_back(edge.from);
+            to.push_back(edge.to);
+            costs.push_back(edge.cost);
+        }
+        std::vector<ClusterEdge>().swap(edges);
+    }
+
+    // Bucket the edges by source node
+    edgeStart_.assign(nodeCells_.size() + 1, 0);
+    for (int node : from) {
+        ++edgeStart_[node + 1];
+    }
+    for (std::size_t node = 0; node < nodeCells_.size(); ++node) {
+        edgeStart_[node + 1] += edgeStart_[node];
+    }
+    edgeTargets_.resize(from.size());
+    edgeCosts_.resize(from.size());
+    std::vector<int> fill(edgeStart_.begin(), edgeStart_.end() - 1);
+    for (std::size_t edge = 0; edge < from.size(); ++edge) {
+        int slot = fill[from[edge]]++;
+        edgeTargets_[slot] = to[edge];
+        edgeCosts_[slot] = costs[edge];
+    }
+}
+
+void AbstractGraph::addEntrances(const Grid& maze, std::vector<int>& from, std::vector<int>& to, std::vector<int>& costs) {
+    std::unordered_map<int, int> nodes;
+    auto node = [&](int id) {
+        std::unordered_map<int, int>::iterator found = nodes.find(id);
+        if (found != nodes.end()) {
+            return found->second;
+        }
+        int created = static_cast<int>(nodeCells_.size());
+        nodeCells_.push_back(id);
+        nodes[id] = created;
+        return created;
+    };
+    auto connect = [&](int a, int b) {
+        int u = node(a), v = node(b);
+        from.push_back(u);
+        to.push_back(v);
+        costs.push_back(1);
+        from.push_back(v);
+        to.push_back(u);
+        costs.push_back(1);
+    };
+    // Cells a and b = a + step face each other across a border; a run of
+    // such open pairs along the border is one entrance
+    auto scanBorder = [&](int first, int along, int step, int length) {
+        int runStart = -1;
+        for (int i = 0; i <= length; ++i) {
+            int a = first + i * along;
+            bool open = i < length && maze[a] != CELL_WALL && maze[a + step] != CELL_WALL;
+            if (open && runStart < 0) {
+                runStart = i;
+            } else if (!open && runStart >= 0) {
+                int runLength = i - runStart;
+                if (runLength < kLongEntrance) {
+                    int middle = first + (runStart + runLength / 2) * along;
+                    connect(middle, middle + step);
+                } else {
+                    int low = first + runStart * along;
+                    int high = first + (i - 1) * along;
+                    connect(low, low + step);
+                    connect(high, high + step);
+                }
+                runStart = -1;
+            }
+        }
+    };
+
+    for (int cy = 0; cy < clustersY_; ++cy) {
+        for (int cx = 0; cx < clustersX_; ++cx) {
+            ClusterBounds area = bounds(cy * clustersX_ + cx);
+            if (area.x1 < width_) {
+                scanBorder(maze.index(area.x1 - 1, area.y0), maze.stride(), maze.offset(1), area.y1 - area.y0);
+            }
+            if (area.y1 < height_) {
+                scanBorder(maze.index(area.x0, area.y1 - 1), 1, maze.offset(3), area.x1 - area.x0);
+            }
+        }
+    }
+}
+
+void AbstractGraph::indexNodes(const Grid& maze) {
+    const int clusters = clustersX_ * clustersY_;
+    clusterStart_.assign(clusters + 1, 0);
+    for (int cell : nodeCells_) {
+        ++clusterStart_[clusterOf(maze.coordinates(cell)) + 1];
+    }
+    for (int cluster = 0; cluster < clusters; ++cluster) {
+        clusterStart_[cluster + 1] += clusterStart_[cluster];
+    }
+    clusterNodes_.resize(nodeCells_.size());
+    std::vector<int> fill(clusterStart_.begin(), clusterStart_.end() - 1);
+    for (std::size_t node = 0; node < nodeCells_.size(); ++node) {
+        clusterNodes_[fill[clusterOf(maze.coordinates(nodeCells_[node]))]++] = static_cast<int>(node);
+    }
+
+    std::vector<std::pair<int, int>> byCell;
+    byCell.reserve(nodeCells_.size());
+    for (std::size_t node = 0; node < nodeCells_.size(); ++node) {
+        byCell.push_back(std::make_pair(nodeCells_[node], static_cast<int>(node)));
+    }
+    std::sort(byCell.begin(), byCell.end());
+    sortedCells_.resize(byCell.size());
+    sortedNodes_.resize(byCell.size());
+    for (std::size_t i = 0; i < byCell.size(); ++i) {
+        sortedCells_[i] = byCell[i].first;
+        sortedNodes_[i] = byCell[i].second;
+    }
+}
+
+ClusterBounds AbstractGraph::bounds(int cluster) const {
+    ClusterBounds area;
+    area.x0 = (cluster % clustersX_) * clusterSize_;
+    area.y0 = (cluster / clustersX_) * clusterSize_;
+    area.x1 = std::min(area.x0 + clusterSize_, width_);
+    area.y1 = std::min(area.y0 + clusterSize_, height_);
+    return area;
+}
+
+int AbstractGraph::nodeAt(int id) const {
+    std::vector<int>::const_iterator found = std::lower_bound(sortedCells_.begin(), sortedCells_.end(), id);
+    if (found == sortedCells_.end() || *found != id) {
+        return -1;
+    }
+    return sortedNodes_[found - sortedCells_.begin()];
+}
+
+std::shared_ptr<AbstractGraph> AbstractGraph::load(const std::string& filename, const Grid& maze,
+                                                   std::uint64_t contentHash, int clusterSize) {
+    std::FILE* file = std::fopen(filename.c_str(), "rb");
+    if (file == nullptr) {
+        return std::shared_ptr<AbstractGraph>();
+    }
+    GraphFileHeader header;
+    std::shared_ptr<AbstractGraph> graph(new AbstractGraph());
+    bool ok = std::fread(&header, sizeof(header), 1, file) == 1 &&
+              std::memcmp(header.magic, kGraphMagic, sizeof(kGraphMagic)) == 0 &&
+              header.version == kGraphVersion && header.contentHash == contentHash &&
+              header.width == static_cast<std::uint32_t>(maze.width()) &&
+              header.height == static_cast<std::uint32_t>(maze.height()) &&
+              header.clusterSize == static_cast<std::uint32_t>(clusterSize) && clusterSize > 0 &&
+              header.edgeCount <= 0x7fffffffu && header.nodeCount <= static_cast<std::uint32_t>(maze.cellCount());
+    ok = ok && readInts(file, graph->nodeCells_, header.nodeCount) &&
+         readInts(file, graph->edgeStart_, header.nodeCount + 1) &&
+         readInts(file, graph->edgeTargets_, header.edgeCount) && readInts(file, graph->edgeCosts_, header.edgeCount);
+    std::fclose(file);
+    if (!ok) {
+        return std::shared_ptr<AbstractGraph>();
+    }
+
+    // The hash guards against stale files, this against corrupt ones
+    const int nodes = static_cast<int>(header.nodeCount);
+    const int edges = static_cast<int>(header.edgeCount);
+    for (int node = 0; node < nodes && ok; ++node) {
+        int cell = graph->nodeCells_[node];
+        ok = cell >= 0 && cell < maze.cellCount() && maze[cell] != CELL_WALL &&
+             graph->edgeStart_[node] <= graph->edgeStart_[node + 1];
+    }
+    ok = ok && graph->edgeStart_[0] == 0 && graph->edgeStart_[nodes] == edges;
+    for (int edge = 0; edge < edges && ok; ++edge) {
+        ok = graph->edgeTargets_[edge] >= 0 && graph->edgeTargets_[edge] < nodes && graph->edgeCosts_[edge] > 0;
+    }
+    if (!ok) {
+        return std::shared_ptr<AbstractGraph>();
+    }
+
+    graph->clusterSize_ = static_cast<int>(header.clusterSize);
+    graph->width_ = maze.width();
+    graph->height_ = maze.height();
+    graph->clustersX_ = (graph->width_ + graph->clusterSize_ - 1) / graph->clusterSize_;
+    graph->clustersY_ = (graph->height_ + graph->clusterSize_ - 1) / graph->clusterSize_;
+    graph->indexNodes(maze);
+    return graph;
+}
+
+bool AbstractGraph::save(const std::string& filename, std::uint64_t contentHash) const {
+    GraphFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kGraphMagic, sizeof(kGraphMagic));
+    header.version = kGraphVersion;
+    header.width = static_cast<std::uint32_t>(width_);
+    header.height = static_cast<std::uint32_t>(height_);
+    header.clusterSize = static_cast<std::uint32_t>(clusterSize_);
+    header.nodeCount = static_cast<std::uint32_t>(nodeCells_.size());
+    header.edgeCount = edgeTargets_.size();
+    header.contentHash = contentHash;
+
+    std::FILE* file = std::fopen(filename.c_str(), "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 && writeInts(file, nodeCells_) &&
+              writeInts(file, edgeStart_) && writeInts(file, edgeTargets_) && writeInts(file, edgeCosts_);
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok) {
+        std::remove(filename.c_str());
+    }
+    return ok;
+}
+
+std::size_t AbstractGraph::memoryBytes() const {
+    return (nodeCells_.capacity() + sortedCells_.capacity() + sortedNodes_.capacity() + clusterStart_.capacity() +
+            clusterNodes_.capacity() + edgeStart_.capacity() + edgeTargets_.capacity() + edgeCosts_.capacity()) *
+           sizeof(int);
+}
@@ -1,8 +1,12 @@
 #include "../include/app_manager.h"
 #include "../include/ui_functions.h"
 #include "../include/algorithms.h"
-#include "../include/maze_loader.h"
+#include "../include/distance_field.h"
+#include "../include/maze_cache.h"
 #include "../include/results_manager.h"
+#include "../include/curses_observer.h"
+#include "../include/maze_editor.h"
+#include <chrono>
 #include <ncurses.h>
 #include <vector>
 
@@ -12,7 +16,11 @@ void initializeApplication(UIState& uiState) {
     uiState.paused = false;
     uiState.finished = false;
     uiState.restart_requested = false;
+    uiState.edit_requested = false;
     uiState.user_quit = false;
+    uiState.view_x = 0;
+    uiState.view_y = 0;
+    uiState.follow_frontier = true;
     uiState.opened_nodes = 0;
     uiState.current_algorithm = 0;
     uiState.current_file = 4;  // Default to maze #5 (index 4)
@@ -20,7 +28,13 @@ void initializeApplication(UIState& uiState) {
     uiState.selected_option = 0;  // Start with "LETS GO!" selected
     
     // Available algorithms
-    uiState.algorithms = {"BFS", "DFS", "Random Search", "Greedy Search", "A*"};
+    uiState.algorithms.clear();
+    for (const AlgorithmInfo& algorithm : availableAlgorithms()) {
+        uiState.algorithms.push_back(algorithm.name);
+    }
+    uiState.race_requested = false;
+    uiState.replay_requested = false;
+    uiState.race_selection.assign(uiState.algorithms.size(), true);
     
     // Available files
     uiState.files.clear();
@@ -33,32 +47,88 @@ void initializeApplication(UIState& uiState) {
     uiState.speed_values = {5.0, 1.0, 0.5, 0.1, 0.05, 0.01, 0.001, 0.0005, 0.0001};
 }
 
-bool loadMaze(const std::string& filename, Matrix& maze, Coordinates& start, Coordinates& end) {
-    maze = readMaze(filename, start, end);
-    return !maze.empty();
+bool loadMaze(const std::string& filename, Grid& maze, Coordinates& start, Coordinates& end) {
+    std::shared_ptr<const CachedMaze> cached = sharedMazeCache().load(filename);
+    if (!cached) {
+        return false;
+    }
+    maze = cached->maze;
+    start = cached->start;
+    end = cached->end;
+    return true;
+}
+
+// Rerun a variant engine and its baseline without the UI, whose delays would
+// swamp the timings. False for engines without a baseline.
+static bool compareWithBaseline(const AlgorithmInfo& algorithm, Grid& maze, const std::string& filename,
+                                const Coordinates& start, const Coordinates& end, SearchWorkspace& workspace,
+                                BaselineComparison& comparison) {
+    int baseline = findAlgorithm(algorithm.baseline);
+    if (baseline < 0) {
+        return false;
+    }
+    const AlgorithmInfo& base = availableAlgorithms()[baseline];
+    prepareMaze(base, maze, filename);
+
+    NullSearchObserver observer;
+    std::vector<Coordinates> path;
+    auto timeRun = [&](const AlgorithmInfo& engine, int& openedNodes) {
+        openedNodes = 0;
+        auto startTime = std::chrono::steady_clock::now();
+        engine.run(maze, start, end, path, openedNodes, workspace, observer);
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    };
+    comparison.baseline = base.name;
+    comparison.solveMs = timeRun(algorithm, comparison.openedNodes);
+    comparison.baselineSolveMs = timeRun(base, comparison.baselineOpenedNodes);
+    return true;
 }
 
 void runAlgorithm(UIState& uiState) {
+    // Search bookkeeping is reused across restarts
+    SearchWorkspace workspace;
+    const AlgorithmInfo& algorithm = availableAlgorithms()[uiState.current_algorithm];
+
+    // Parsed and prepared once per file and engine, so choosing the maze
+    // again or restarting only copies the pristine maze. The first
+    // preparation can take seconds on large mazes (e.g. the HPA* graph).
+    clear();
+    mvprintw(LINES/2, (COLS-17)/2, "Preparing maze...");
+    refresh();
+    std::shared_ptr<const CachedMaze> source = sharedMazeCache().load(uiState.files[uiState.current_file], &algorithm);
+    if (!source) {
+        clear();
+        mvprintw(LINES/2, (COLS-30)/2, "Error loading maze file!");
+        mvprintw(LINES/2+1, (COLS-30)/2, "Press any key to continue...");
+        refresh();
+        getch();
+        return;
+    }
+
+    // Working copy for the wall editor, and the overlay holding the search
+    // markers. Both are kept across restarts: the copy is only refreshed
+    // after edits, reusing its storage, and the overlay is cleared.
+    Grid maze = source->maze;
+    const Coordinates start = source->start;
+    const Coordinates end = source->end;
+    MazeRenderer renderer(maze);
+    bool edited = false;
+    const std::string fieldKey = distanceFieldKey(uiState.files[uiState.current_file], source->contentHash);
+
     while (true) {
-        // Load maze data
-        Matrix maze;
-        Coordinates start, end;
-        
-        if (!loadMaze(uiState.files[uiState.current_file], maze, start, end)) {
-            clear();
-            mvprintw(LINES/2, (COLS-30)/2, "Error loading maze file!");
-            mvprintw(LINES/2+1, (COLS-30)/2, "Press any key to continue...");
-            refresh();
-            getch();
-            return;
+        if (edited) {
+            maze = source->maze;
+            renderer.wallsReplaced();
+            edited = false;
         }
-        
+        renderer.clearMarks();
+
         // Initialize UI for pathfinding
         clear();
         drawHeader();
         
-        // Check terminal size for maze
-        checkTerminalSize(maze, uiState);
+        // Check terminal size for the UI
+        checkTerminalSize(uiState);
         if (uiState.user_quit) {
             uiState.user_quit = false; // Reset for next time
             return;
@@ -69,11 +139,15 @@ void runAlgorithm(UIState& uiState) {
         uiState.paused = false;
         uiState.finished = false;
         uiState.restart_requested = false;
+        uiState.edit_requested = false;
         uiState.user_quit = false;
         uiState.opened_nodes = 0;
+        uiState.view_x = 0;
+        uiState.view_y = 0;
+        uiState.follow_frontier = true;
         
         // Draw initial maze and status
-        drawMaze(maze, uiState);
+        renderer.redrawAll(uiState);
         updateStatus(uiState);
         refresh();
         
@@ -82,24 +156,8 @@ void runAlgorithm(UIState& uiState) {
         int openedNodes = 0;
         
         // Run the selected algorithm
-        bool pathFound = false;
-        switch (uiState.current_algorithm) {
-            case 0:  // BFS
-                pathFound = findPathBFS(maze, start, end, path, openedNodes, uiState.speed, uiState);
-                break;
-            case 1:  // DFS
-                pathFound = findPathDFS(maze, start, end, path, openedNodes, uiState.speed, uiState);
-                break;
-            case 2:  // Random Search
-                pathFound = findPathRandomSearch(maze, start, end, path, openedNodes, uiState.speed, uiState);
-                break;
-            case 3:  // Greedy Search
-                pathFound = findPathGreedySearch(maze, start, end, path, openedNodes, uiState.speed, uiState);
-                break;
-            case 4:  // A*
-                pathFound = findPathAStar(maze, start, end, path, openedNodes, uiState.speed, uiState);
-                break;
-        }
+        CursesSearchObserver observer(uiState, renderer);
+        bool pathFound = algorithm.run(maze, start, end, path, openedNodes, workspace, observer);
         
         // Algorithm has finished - set running to false immediately
         uiState.running = false;
@@ -121,8 +179,38 @@ void runAlgorithm(UIState& uiState) {
         updateStatus(uiState);
         refresh();
         
+        // Measured before the baseline rerun reuses the workspace
+        RunMemory memory;
+        workspace.memoryUsage(maze, path, memory);
+
         // Show final results briefly, then return to main menu
-        showFinalResults(maze, pathFound, path, openedNodes, uiState);
+        BaselineComparison comparison;
+        bool compared = compareWithBaseline(algorithm, maze, uiState.files[uiState.current_file], start, end,
+                                            workspace, comparison);
+
+        // Shortest possible length: the path itself for engines that only
+        // find shortest ones, else read off the end's distance field when
+        // one is already cached. Flooding the maze here would cost O(cells)
+        // after a search that may have opened a few hundred.
+        int shortestLength = -1;
+        if (pathFound && algorithm.shortestPaths) {
+            shortestLength = static_cast<int>(path.size());
+        } else if (std::shared_ptr<const DistanceField> field =
+                       sharedDistanceFieldCache().cached(fieldKey, maze.index(end))) {
+            int moves = field->distance(maze.index(start));
+            shortestLength = moves >= 0 ? moves + 1 : -1;
+        }
+        showFinalResults(renderer, pathFound, path, openedNodes, uiState, compared ? &comparison : nullptr, &memory,
+                         shortestLength);
+        
+        // Edit walls in place until the results screen is left another way;
+        // the comparison no longer applies to the edited maze
+        while (uiState.edit_requested) {
+            uiState.edit_requested = false;
+            edited = true;
+            pathFound = editMaze(maze, start, end, renderer, uiState, path, openedNodes);
+            showFinalResults(renderer, pathFound, path, openedNodes, uiState);
+        }
         
         // If restart was requested after final results, restart
         if (uiState.restart_requested) {
@@ -0,0 +1,261 @@
+#include "../include/batch_solver.h"
+#include "../include/bounded_queue.h"
+#include "../include/maze_loader.h"
+#include "../include/parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <fstream>
+#include <glob.h>
+#include <map>
+#include <sys/stat.h>
+#include <thread>
+#include <utility>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+double millisecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// A maze handed from the load stage to the solve stage
+struct LoadedMaze {
+    std::size_t index;
+    std::string name;
+    Grid maze;
+    Coordinates start, end;
+    double loadMs;
+};
+
+// A finished solve handed to the writer; maze is only kept when solved
+// mazes are written out
+struct SolvedMaze {
+    std::size_t index;
+    SolveReport report;
+    Grid maze;
+    Coordinates start, end;
+};
+
+void solveLoaded(const Grid& maze, const Coordinates& start, const Coordinates& end, const AlgorithmInfo& algorithm,
+                 SearchWorkspace& workspace, SolveReport& report) {
+    NullSearchObserver observer;
+    report.width = maze.width();
+    report.height = maze.height();
+    report.openedNodes = 0;
+    Clock::time_point solveStart = Clock::now();
+    report.found = algorithm.run(maze, start, end, report.path, report.openedNodes, workspace, observer);
+    report.solveMs = millisecondsSince(solveStart);
+    report.pushes = workspace.pushes();
+    workspace.memoryUsage(maze, report.path, report.memory);
+}
+
+SolveReport failedLoad(const std::string& name, double loadMs) {
+    SolveReport report;
+    report.maze = name;
+    report.loaded = false;
+    report.found = false;
+    report.width = report.height = 0;
+    report.openedNodes = 0;
+    report.pushes = 0;
+    report.loadMs = loadMs;
+    report.solveMs = 0.0;
+    return report;
+}
+
+// dataset/2.txt sorts before dataset/10.txt
+bool naturalLess(const std::string& a, const std::string& b) {
+    return a.size() != b.size() ? a.size() < b.size() : a < b;
+}
+
+std::string solvedMazeName(const std::string& outputDir, const std::string& maze) {
+    std::string base = maze.substr(maze.find_last_of('/') + 1);
+    std::size_t dot = base.find_last_of('.');
+    if (dot != std::string::npos && dot > 0) {
+        base.erase(dot);
+    }
+    return outputDir + "/" + base + ".solved.txt";
+}
+
+void writeRow(std::FILE* out, const SolveReport& report, const std::string& algorithm) {
+    std::fprintf(out, "%s,%s,%d,%d,%zu,%d,%.3f,%.3f\n", report.maze.c_str(), algorithm.c_str(),
+                 report.loaded ? 1 : 0, report.found ? 1 : 0, report.path.size(), report.openedNodes,
+                 report.loadMs, report.solveMs);
+}
+
+} // namespace
+
+SolveReport solveMazeFile(const std::string& filename, const AlgorithmInfo& algorithm,
+                          SearchWorkspace& workspace, Grid* solved, Coordinates* start, Coordinates* end) {
+    Coordinates mazeStart, mazeEnd;
+    Clock::time_point loadStart = Clock::now();
+    Grid maze = readMaze(filename, mazeStart, mazeEnd);
+    prepareMaze(algorithm, maze, filename);
+    SolveReport report = failedLoad(filename, millisecondsSince(loadStart));
+    if (maze.empty()) {
+        return report;
+    }
+
+    report.loaded = true;
+    solveLoaded(maze, mazeStart, mazeEnd, algorithm, workspace, report);
+    if (solved != nullptr) {
+        *solved = std::move(maze);
+    }
+    if (start != nullptr) {
+        *start = mazeStart;
+    }
+    if (end != nullptr) {
+        *end = mazeEnd;
+    }
+    return report;
+}
+
+bool collectBatchMazes(const std::string& path, std::vector<std::string>& mazes) {
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0) {
+        std::fprintf(stderr, "Error: Could not open %s\n", path.c_str());
+        return false;
+    }
+
+    if (S_ISDIR(info.st_mode)) {
+        std::vector<std::string> found;
+        const char* patterns[] = {"/*.txt", "/*.mzb"};
+        for (const char* pattern : patterns) {
+            glob_t matches;
+            if (glob((path + pattern).c_str(), 0, nullptr, &matches) == 0) {
+                for (std::size_t i = 0; i < matches.gl_pathc; ++i) {
+                    found.push_back(matches.gl_pathv[i]);
+                }
+            }
+            globfree(&matches);
+        }
+        std::sort(found.begin(), found.end(), naturalLess);
+        mazes.insert(mazes.end(), found.begin(), found.end());
+        return true;
+    }
+
+    std::ifstream manifest(path);
+    if (!manifest.is_open()) {
+        std::fprintf(stderr, "Error: Could not open %s\n", path.c_str());
+        return false;
+    }
+    std::size_t slash = path.find_last_of('/');
+    std::string baseDir = slash == std::string::npos ? "" : path.substr(0, slash + 1);
+    std::string line;
+    while (std::getline(manifest, line)) {
+        std::size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#') {
+            continue;
+        }
+        std::size_t last = line.find_last_not_of(" \t\r");
+        std::string maze = line.substr(first, last - first + 1);
+        mazes.push_back(maze[0] == '/' ? maze : baseDir + maze);
+    }
+    return true;
+}
+
+int runBatch(const BatchOptions& options, std::FILE* out) {
+    const AlgorithmInfo& algorithm = availableAlgorithms()[options.algorithm];
+    int solvers = std::max(1, options.jobs);
+    int loaders = std::max(1, solvers / 2);
+    bool keepMazes = !options.outputDir.empty();
+    if (keepMazes && mkdir(options.outputDir.c_str(), 0755) != 0 && errno != EEXIST) {
+        std::fprintf(stderr, "Error: Could not create %s\n", options.outputDir.c_str());
+        return static_cast<int>(options.mazes.size());
+    }
+
+    BoundedQueue<LoadedMaze> loaded(solvers);
+    BoundedQueue<SolvedMaze> solved(solvers * 2);
+    std::atomic<std::size_t> nextMaze(0);
+    std::atomic<int> activeLoaders(loaders);
+    std::atomic<int> activeSolvers(solvers);
+    Clock::time_point batchStart = Clock::now();
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < loaders; ++i) {
+        threads.push_back(std::thread([&]() {
+            // Parallelism comes from the pipeline, so each load runs on one thread
+            ThreadWorkerLimit limit(1);
+            for (std::size_t index = nextMaze++; index < options.mazes.size(); index = nextMaze++) {
+                LoadedMaze item;
+                item.index = index;
+                item.name = options.mazes[index];
+                Clock::time_point loadStart = Clock::now();
+                item.maze = readMaze(item.name, item.start, item.end);
+                prepareMaze(algorithm, item.maze, item.name);
+                item.loadMs = millisecondsSince(loadStart);
+                if (!loaded.push(std::move(item))) {
+                    break;
+                }
+            }
+            if (--activeLoaders == 0) {
+                loaded.close();
+            }
+        }));
+    }
+
+    for (int i = 0; i < solvers; ++i) {
+        threads.push_back(std::thread([&]() {
+            ThreadWorkerLimit limit(1);
+            SearchWorkspace workspace;
+            LoadedMaze item;
+            while (loaded.pop(item)) {
+                SolvedMaze result;
+                result.index = item.index;
+                result.report = failedLoad(item.name, item.loadMs);
+                if (!item.maze.empty()) {
+                    result.report.loaded = true;
+                    solveLoaded(item.maze, item.start, item.end, algorithm, workspace, result.report);
+                    if (keepMazes) {
+                        result.maze = std::move(item.maze);
+                        result.start = item.start;
+                        result.end = item.end;
+                    }
+                }
+                item.maze = Grid();
+                if (!solved.push(std::move(result))) {
+                    break;
+                }
+            }
+            if (--activeSolvers == 0) {
+                solved.close();
+            }
+        }));
+    }
+
+    // Writer: solved mazes go to disk as they arrive, report rows are
+    // printed in input order
+    int failures = 0;
+    std::size_t nextRow = 0;
+    std::map<std::size_t, SolveReport> pending;
+    std::fprintf(out, "maze,algorithm,loaded,found,path_length,opened_nodes,load_ms,solve_ms\n");
+    SolvedMaze result;
+    while (solved.pop(result)) {
+        if (!result.report.loaded) {
+            ++failures;
+        } else if (keepMazes && !writeSolvedMaze(solvedMazeName(options.outputDir, result.report.maze),
+                                                 result.maze, result.report.path, result.start, result.end)) {
+            ++failures;
+        }
+        result.maze = Grid();
+        pending[result.index] = std::move(result.report);
+        for (std::map<std::size_t, SolveReport>::iterator row = pending.find(nextRow); row != pending.end();
+             row = pending.find(++nextRow)) {
+            writeRow(out, row->second, algorithm.key);
+            pending.erase(row);
+        }
+    }
+    std::fflush(out);
+
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    double elapsedMs = millisecondsSince(batchStart);
+    std::fprintf(stderr, "%zu mazes (%d failed) in %.1f ms, %.1f mazes/s, %d loader and %d solver threads\n",
+                 options.mazes.size(), failures, elapsedMs,
+                 elapsedMs > 0 ? options.mazes.size() * 1000.0 / elapsedMs : 0.0, loaders, solvers);
+    return failures;
+}
@@ -0,0 +1,117 @@
+#include "../include/binary_maze.h"
+#include "../include/parallel.h"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+// Rows handed to each loader thread at minimum
+const int kRowsPerChunk = 256;
+
+} // namespace
+
+std::uint64_t hashWalls(const std::uint64_t* words, std::size_t count) {
+    // FNV-1a style mixing, one 64-bit word at a time
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (std::size_t i = 0; i < count; ++i) {
+        hash ^= words[i];
+        hash *= 1099511628211ULL;
+        hash ^= hash >> 29;
+    }
+    return hash;
+}
+
+std::uint64_t hashWalls(const WallBitmap& walls) {
+    std::uint64_t hash = hashWalls(walls.words().data(), walls.words().size());
+    // Fold in the dimensions so equal bit patterns of other shapes differ
+    return hash ^ ((static_cast<std::uint64_t>(walls.width()) << 32) | static_cast<std::uint32_t>(walls.height()));
+}
+
+bool isBinaryMaze(const char* data, std::size_t size) {
+    return size >= sizeof(BinaryMazeHeader) && std::memcmp(data, kBinaryMazeMagic, sizeof(kBinaryMazeMagic)) == 0;
+}
+
+Grid parseBinaryMaze(const char* data, std::size_t size, const std::string& filename,
+                     Coordinates& start, Coordinates& end) {
+    BinaryMazeHeader header;
+    std::memcpy(&header, data, sizeof(header));
+
+    if (header.version != kBinaryMazeVersion) {
+        std::cerr << "Error: Unsupported binary maze version " << header.version << " in " << filename << std::endl;
+        return Grid();
+    }
+
+    int width = static_cast<int>(header.width);
+    int height = static_cast<int>(header.height);
+    if (!Grid::fits(header.width, header.height) || header.wordsPerRow != (header.width + 63) / 64) {
+        std::cerr << "Error: Invalid maze dimensions in " << filename << std::endl;
+        return Grid();
+    }
+
+    std::uint64_t bitmapBytes = static_cast<std::uint64_t>(header.wordsPerRow) * header.height * sizeof(std::uint64_t);
+    if (header.dataOffset < sizeof(BinaryMazeHeader) || header.dataOffset % sizeof(std::uint64_t) != 0 ||
+        header.dataOffset + bitmapBytes > size) {
+        std::cerr << "Error: Truncated binary maze file " << filename << std::endl;
+        return Grid();
+    }
+
+    start = Coordinates(header.startX, header.startY);
+    end = Coordinates(header.endX, header.endY);
+    if (start.first < 0 || start.first >= width || start.second < 0 || start.second >= height ||
+        end.first < 0 || end.first >= width || end.second < 0 || end.second >= height) {
+        std::cerr << "Error: Invalid coordinates in " << filename << std::endl;
+        return Grid();
+    }
+
+    // The bitmap is used in place; rows are faulted in by the copy below
+    const std::uint64_t* words = reinterpret_cast<const std::uint64_t*>(data + header.dataOffset);
+    int wordsPerRow = static_cast<int>(header.wordsPerRow);
+
+    Grid maze(width, height);
+    parallelForRanges(height, kRowsPerChunk, [&](int first, int last) {
+        maze.setWalls(words, wordsPerRow, first, last);
+    });
+
+    // Mark start and end positions in the maze
+    maze.at(start.first, start.second) = CELL_START;
+    maze.at(end.first, end.second) = CELL_END;
+    parallelForRanges(height, kRowsPerChunk, [&](int first, int last) {
+        maze.computeNeighbourMasks(first, last);
+    });
+
+    return maze;
+}
+
+bool writeBinaryMaze(const std::string& filename, const WallBitmap& walls,
+                     const Coordinates& start, const Coordinates& end) {
+    BinaryMazeHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kBinaryMazeMagic, sizeof(kBinaryMazeMagic));
+    header.version = kBinaryMazeVersion;
+    header.width = static_cast<std::uint32_t>(walls.width());
+    header.height = static_cast<std::uint32_t>(walls.height());
+    header.startX = start.first;
+    header.startY = start.second;
+    header.endX = end.first;
+    header.endY = end.second;
+    header.wordsPerRow = static_cast<std::uint32_t>(walls.wordsPerRow());
+    header.contentHash = hashWalls(walls);
+    header.dataOffset = sizeof(BinaryMazeHeader);
+
+    std::FILE* file = std::fopen(filename.c_str(), "wb");
+    if (file == nullptr) {
+        std::cerr << "Error: Could not open file " << filename << " for writing" << std::endl;
+        return false;
+    }
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+    const std::vector<std::uint64_t>& words = walls.words();
+    if (ok && !words.empty()) {
+        ok = std::fwrite(words.data(), sizeof(std::uint64_t), words.size(), file) == words.size();
+    }
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok) {
+        std::cerr << "Error: Could not write " << filename << std::endl;
+    }
+    return ok;
+}
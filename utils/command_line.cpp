@@ -0,0 +1,454 @@
+#include "../include/command_line.h"
+#include "../include/batch_solver.h"
+#include "../include/binary_maze.h"
+#include "../include/d_star_lite.h"
+#include "../include/distance_field.h"
+#include "../include/maze_loader.h"
+#include "../include/parallel.h"
+#include "../include/query_solver.h"
+#include "../include/search_trace.h"
+#include "../include/tiled_search.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
+
+namespace {
+
+void printUsage(const char* program) {
+    std::fprintf(stderr,
+                 "Usage: %s                          interactive visualizer\n"
+                 "       %s --solve FILE [--algo KEY] [--no-path] [--cluster N]\n"
+                 "       %s --solve FILE --queries STARTS\n"
+                 "       %s --solve FILE --edits TOGGLES\n"
+                 "       %s --solve FILE --pairs PAIRS [--algo KEY] [--jobs N]\n"
+                 "       %s --solve FILE --trace OUT.mzr [--algo KEY]\n"
+                 "       %s --replay OUT.mzr\n"
+                 "       %s --solve FILE.mzt [--algo bfs|astar] [--cache-mb N] [--no-path]\n"
+                 "       %s --batch DIR|MANIFEST [--algo KEY] [--jobs N] [--out DIR]\n"
+                 "Algorithms:",
+                 program, program, program, program, program, program, program, program, program);
+    for (const AlgorithmInfo& algorithm : availableAlgorithms()) {
+        std::fprintf(stderr, " %s", algorithm.key.c_str());
+    }
+    std::fprintf(stderr, "\n");
+}
+
+void printMemoryLine(const char* name, const MemoryUsage& usage) {
+    std::printf("memory_%s: %s (peak %s, %lld allocations)\n", name, formatBytes(usage.bytes).c_str(),
+                formatBytes(usage.peakBytes).c_str(), usage.allocations);
+}
+
+// Allocations are those made by this run; a workspace reused across runs
+// reports none once its arrays are large enough
+void printRunMemory(const RunMemory& memory) {
+    printMemoryLine("parents", memory.parents);
+    printMemoryLine("frontier", memory.frontier);
+    printMemoryLine("path", memory.path);
+    printMemoryLine("maze", memory.maze);
+    std::printf("peak_frontier: %zu\n", memory.peakFrontier);
+}
+
+int solveOne(const std::string& filename, int algorithmIndex, bool printPath) {
+    const AlgorithmInfo& algorithm = availableAlgorithms()[algorithmIndex];
+    SearchWorkspace workspace;
+    Grid maze;
+    Coordinates start, end;
+    SolveReport report = solveMazeFile(filename, algorithm, workspace, &maze, &start, &end);
+    if (!report.loaded) {
+        return 2;
+    }
+
+    std::printf("maze: %s\n", report.maze.c_str());
+    std::printf("algorithm: %s (%s)\n", algorithm.key.c_str(), algorithm.name.c_str());
+    std::printf("size: %dx%d\n", report.width, report.height);
+    std::printf("found: %s\n", report.found ? "yes" : "no");
+    std::printf("path_length: %zu\n", report.path.size());
+    std::printf("opened_nodes: %d\n", report.openedNodes);
+    std::printf("pushes: %lld\n", report.pushes);
+    std::printf("load_ms: %.3f\n", report.loadMs);
+    std::printf("solve_ms: %.3f\n", report.solveMs);
+    printRunMemory(report.memory);
+
+    // Variants also report what they saved over the engine they refine.
+    // solve_ms above paid for growing the workspace, so both engines are
+    // timed again here on the workspace the baseline's warm-up run grew.
+    int baseline = findAlgorithm(algorithm.baseline);
+    if (baseline >= 0) {
+        const AlgorithmInfo& base = availableAlgorithms()[baseline];
+        prepareMaze(base, maze, filename);
+        NullSearchObserver observer;
+        std::vector<Coordinates> runPath;
+        auto timeRun = [&](const AlgorithmInfo& engine, int& openedNodes) {
+            openedNodes = 0;
+            auto startTime = std::chrono::steady_clock::now();
+            engine.run(maze, start, end, runPath, openedNodes, workspace, observer);
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+        };
+        int variantOpened = 0, baseOpened = 0;
+        timeRun(base, baseOpened);
+        double variantMs = timeRun(algorithm, variantOpened);
+        double baseMs = timeRun(base, baseOpened);
+        int saved = baseOpened - report.openedNodes;
+        std::printf("baseline: %s\n", base.key.c_str());
+        std::printf("baseline_opened_nodes: %d\n", baseOpened);
+        std::printf("opened_nodes_saved: %d (%.1f%%)\n", saved, baseOpened > 0 ? saved * 100.0 / baseOpened : 0.0);
+        std::printf("baseline_pushes: %lld\n", workspace.pushes());
+        std::printf("warm_solve_ms: %.3f\n", variantMs);
+        std::printf("baseline_solve_ms: %.3f\n", baseMs);
+    }
+    if (printPath && report.found) {
+        std::printf("path:");
+        for (const Coordinates& p : report.path) {
+            std::printf(" %d,%d", p.first, p.second);
+        }
+        std::printf("\n");
+    }
+    return report.found ? 0 : 1;
+}
+
+// Run the engine headless at full speed, recording every opened cell and
+// the path for --replay
+int recordTrace(const std::string& filename, int algorithmIndex, const std::string& traceFile) {
+    const AlgorithmInfo& algorithm = availableAlgorithms()[algorithmIndex];
+    Coordinates start, end;
+    Grid maze = readMaze(filename, start, end);
+    if (maze.empty()) {
+        std::fprintf(stderr, "Could not load %s\n", filename.c_str());
+        return 2;
+    }
+    prepareMaze(algorithm, maze, filename);
+
+    SearchWorkspace workspace;
+    auto started = std::chrono::steady_clock::now();
+    SearchTrace trace = recordSearch(algorithm, maze, filename, start, end, workspace);
+    double solveMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+    if (!writeTrace(traceFile, trace)) {
+        return 2;
+    }
+    struct stat info;
+    long long traceBytes = stat(traceFile.c_str(), &info) == 0 ? static_cast<long long>(info.st_size) : -1;
+
+    std::printf("maze: %s\n", filename.c_str());
+    std::printf("algorithm: %s (%s)\n", algorithm.key.c_str(), algorithm.name.c_str());
+    std::printf("found: %s\n", trace.found ? "yes" : "no");
+    std::printf("path_length: %zu\n", trace.path.size());
+    std::printf("opened_nodes: %zu\n", trace.expanded.size());
+    std::printf("solve_ms: %.3f\n", solveMs);
+    std::printf("trace: %s\n", traceFile.c_str());
+    std::printf("trace_bytes: %lld\n", traceBytes);
+    return trace.found ? 0 : 1;
+}
+
+// Paths from many starts to the maze's end, each read off the end's
+// distance field. STARTS holds one "x,y" per line.
+int answerQueries(const std::string& filename, const std::string& queriesFile) {
+    Coordinates start, end;
+    Grid maze = readMaze(filename, start, end);
+    if (maze.empty()) {
+        std::fprintf(stderr, "Could not load %s\n", filename.c_str());
+        return 2;
+    }
+    std::FILE* queries = std::fopen(queriesFile.c_str(), "r");
+    if (queries == nullptr) {
+        std::fprintf(stderr, "Could not open %s\n", queriesFile.c_str());
+        return 2;
+    }
+
+    DistanceFieldCache& cache = sharedDistanceFieldCache();
+    const std::string mazeKey = distanceFieldKey(filename, hashWalls(maze.walls()));
+    auto fieldStart = std::chrono::steady_clock::now();
+    cache.field(mazeKey, maze, maze.index(end));
+    double fieldMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - fieldStart).count();
+
+    std::printf("maze: %s\n", filename.c_str());
+    std::printf("goal: %d,%d\n", end.first, end.second);
+    std::printf("field_ms: %.3f\n", fieldMs);
+    std::vector<Coordinates> path;
+    int answered = 0, unreachable = 0;
+    double queryMs = 0.0;
+    int x, y;
+    while (std::fscanf(queries, " %d , %d", &x, &y) == 2) {
+        if (x < 0 || x >= maze.width() || y < 0 || y >= maze.height()) {
+            std::printf("query %d,%d: outside the maze\n", x, y);
+            ++unreachable;
+            continue;
+        }
+        auto queryStart = std::chrono::steady_clock::now();
+        bool found = cache.findPath(mazeKey, maze, Coordinates(x, y), end, path);
+        queryMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - queryStart).count();
+        ++answered;
+        if (found) {
+            std::printf("query %d,%d: path_length %zu\n", x, y, path.size());
+        } else {
+            std::printf("query %d,%d: no path\n", x, y);
+            ++unreachable;
+        }
+    }
+    std::fclose(queries);
+    std::printf("queries: %d\n", answered);
+    std::printf("query_ms: %.3f\n", queryMs);
+    return unreachable == 0 ? 0 : 1;
+}
+
+// Toggle the wall on every "x,y" line of EDITS in turn and let one D* Lite
+// planner repair the path after each, next to an A* solve of the final maze
+int replanEdits(const std::string& filename, const std::string& editsFile) {
+    Coordinates start, end;
+    Grid maze = readMaze(filename, start, end);
+    if (maze.empty()) {
+        std::fprintf(stderr, "Could not load %s\n", filename.c_str());
+        return 2;
+    }
+    std::FILE* edits = std::fopen(editsFile.c_str(), "r");
+    if (edits == nullptr) {
+        std::fprintf(stderr, "Could not open %s\n", editsFile.c_str());
+        return 2;
+    }
+
+    NullSearchObserver observer;
+    std::vector<Coordinates> path;
+    DStarLite planner(maze, maze.index(start), maze.index(end));
+    int openedNodes = 0;
+    auto planStart = std::chrono::steady_clock::now();
+    planner.plan(observer, openedNodes);
+    double planMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - planStart).count();
+    planner.path(path);
+    std::printf("maze: %s\n", filename.c_str());
+    std::printf("initial_path_length: %zu\n", path.size());
+    std::printf("initial_opened_nodes: %d\n", openedNodes);
+    std::printf("initial_ms: %.3f\n", planMs);
+
+    int applied = 0;
+    long long repairedNodes = 0;
+    double repairMs = 0.0;
+    int x, y;
+    while (std::fscanf(edits, " %d , %d", &x, &y) == 2) {
+        Coordinates cell(x, y);
+        if (x < 0 || x >= maze.width() || y < 0 || y >= maze.height() || cell == start || cell == end) {
+            std::printf("edit %d,%d: not editable\n", x, y);
+            continue;
+        }
+        int id = maze.index(cell);
+        bool wall = maze[id] != CELL_WALL;
+        maze.setWall(id, wall);
+        planner.cellChanged(id);
+        openedNodes = 0;
+        auto editStart = std::chrono::steady_clock::now();
+        planner.plan(observer, openedNodes);
+        double editMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - editStart).count();
+        ++applied;
+        repairedNodes += openedNodes;
+        repairMs += editMs;
+        if (planner.path(path)) {
+            std::printf("edit %d,%d: %s path_length %zu repaired_nodes %d repair_ms %.3f\n", x, y,
+                        wall ? "wall" : "open", path.size(), openedNodes, editMs);
+        } else {
+            std::printf("edit %d,%d: %s no path repaired_nodes %d repair_ms %.3f\n", x, y,
+                        wall ? "wall" : "open", openedNodes, editMs);
+        }
+    }
+    std::fclose(edits);
+
+    // What answering the last edit from scratch would have cost
+    SearchWorkspace workspace;
+    std::vector<Coordinates> fresh;
+    int freshOpened = 0;
+    auto freshStart = std::chrono::steady_clock::now();
+    bool found = findPathAStar(maze, start, end, fresh, freshOpened, workspace, observer);
+    double freshMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - freshStart).count();
+    std::printf("edits: %d\n", applied);
+    std::printf("repaired_nodes: %lld\n", repairedNodes);
+    std::printf("repair_ms: %.3f\n", repairMs);
+    std::printf("astar_path_length: %zu\n", found ? fresh.size() : 0);
+    std::printf("astar_opened_nodes: %d\n", freshOpened);
+    std::printf("astar_ms: %.3f\n", freshMs);
+    return planner.pathExists() ? 0 : 1;
+}
+
+// Solve every "x,y x,y" (start, end) line of PAIRS on one loaded maze as a
+// single batch on jobs threads
+int solvePairs(const std::string& filename, const std::string& pairsFile, int algorithmIndex, int jobs) {
+    const AlgorithmInfo& algorithm = availableAlgorithms()[algorithmIndex];
+    Coordinates start, end;
+    Grid maze = readMaze(filename, start, end);
+    if (maze.empty()) {
+        std::fprintf(stderr, "Could not load %s\n", filename.c_str());
+        return 2;
+    }
+    std::FILE* pairs = std::fopen(pairsFile.c_str(), "r");
+    if (pairs == nullptr) {
+        std::fprintf(stderr, "Could not open %s\n", pairsFile.c_str());
+        return 2;
+    }
+    std::vector<PathQuery> queries;
+    PathQuery query;
+    while (std::fscanf(pairs, " %d , %d %d , %d", &query.start.first, &query.start.second, &query.end.first,
+                       &query.end.second) == 4) {
+        queries.push_back(query);
+    }
+    std::fclose(pairs);
+    prepareMaze(algorithm, maze, filename);
+
+    // Ends shared by several pairs are read off their distance field
+    QuerySolver solver(maze, algorithm, jobs);
+    solver.useDistanceFields(&sharedDistanceFieldCache(), distanceFieldKey(filename, hashWalls(maze.walls())));
+    std::vector<QueryResult> results;
+    QueryBatchStats stats = solver.solve(queries, results);
+
+    std::printf("maze: %s\n", filename.c_str());
+    std::printf("algorithm: %s (%s)\n", algorithm.key.c_str(), algorithm.name.c_str());
+    for (std::size_t i = 0; i < queries.size(); ++i) {
+        const QueryResult& result = results[i];
+        std::printf("query %d,%d %d,%d: ", queries[i].start.first, queries[i].start.second, queries[i].end.first,
+                    queries[i].end.second);
+        if (result.found) {
+            std::printf("path_length %zu", result.pathLength);
+        } else {
+            std::printf("no path");
+        }
+        std::printf(" opened_nodes %d solve_ms %.3f%s\n", result.openedNodes, result.solveMs,
+                    result.fromField ? " (distance field)" : "");
+    }
+    std::printf("queries: %zu\n", stats.queries);
+    std::printf("found: %zu\n", stats.found);
+    std::printf("field_queries: %zu\n", stats.fieldQueries);
+    std::printf("threads: %d\n", stats.threads);
+    std::printf("elapsed_ms: %.3f\n", stats.elapsedMs);
+    std::printf("solve_ms: %.3f\n", stats.solveMs);
+    std::printf("queries_per_s: %.1f\n", stats.queriesPerSecond);
+    std::printf("workspace_bytes: %zu\n", solver.memoryBytes());
+    return stats.found == stats.queries ? 0 : 1;
+}
+
+// Solve a tiled maze without loading it: tiles and search state are paged
+// through caches of cacheMb megabytes each
+int solveTiled(const std::string& filename, const std::string& algorithmKey, std::size_t cacheMb, bool printPath) {
+    TiledEngine engine;
+    if (!parseTiledEngine(algorithmKey, engine)) {
+        std::fprintf(stderr, "Tiled mazes are solved with bfs or astar, not '%s'\n", algorithmKey.c_str());
+        return 2;
+    }
+    std::size_t cacheBytes = cacheMb << 20;
+    TiledMaze maze;
+    if (!maze.open(filename, cacheBytes)) {
+        return 2;
+    }
+
+    TiledSearchStats stats;
+    std::vector<LargeCoordinates> path;
+    auto started = std::chrono::steady_clock::now();
+    findPathTiled(maze, engine, cacheBytes, stats, printPath ? &path : nullptr);
+    double solveMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+    if (!stats.ioOk) {
+        std::fprintf(stderr, "Could not read or write tiles while solving %s\n", filename.c_str());
+        return 2;
+    }
+
+    std::printf("maze: %s\n", filename.c_str());
+    std::printf("algorithm: %s (tiled)\n", algorithmKey.c_str());
+    std::printf("size: %lldx%lld\n", static_cast<long long>(maze.width()), static_cast<long long>(maze.height()));
+    std::printf("tile_size: %d\n", maze.tileSize());
+    std::printf("found: %s\n", stats.found ? "yes" : "no");
+    std::printf("path_length: %lld\n", static_cast<long long>(stats.pathLength));
+    std::printf("opened_nodes: %lld\n", stats.openedNodes);
+    std::printf("pushes: %lld\n", stats.pushes);
+    std::printf("peak_frontier: %lld\n", stats.peakFrontier);
+    std::printf("tile_loads: %lld of %lld tiles\n", maze.cache().loads(), static_cast<long long>(maze.tileCount()));
+    std::printf("tile_evictions: %lld\n", maze.cache().evictions());
+    std::printf("state_loads: %lld\n", stats.stateLoads);
+    std::printf("state_write_backs: %lld\n", stats.stateWriteBacks);
+    std::printf("cache_bytes: %zu\n", maze.cache().memoryBytes() + stats.stateBytes);
+    std::printf("solve_ms: %.3f\n", solveMs);
+    if (printPath && stats.found) {
+        std::printf("path:");
+        for (const LargeCoordinates& p : path) {
+            std::printf(" %lld,%lld", static_cast<long long>(p.first), static_cast<long long>(p.second));
+        }
+        std::printf("\n");
+    }
+    return stats.found ? 0 : 1;
+}
+
+} // namespace
+
+int runCommandLine(int argc, char** argv) {
+    std::string solveFile, batchSource, outputDir, queriesFile, editsFile, pairsFile, traceFile;
+    int algorithm = 0;
+    int jobs = workerCount();
+    std::size_t cacheMb = 256;
+    bool printPath = true;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--solve" && hasValue) {
+            solveFile = argv[++i];
+        } else if (arg == "--batch" && hasValue) {
+            batchSource = argv[++i];
+        } else if (arg == "--algo" && hasValue) {
+            algorithm = findAlgorithm(argv[++i]);
+            if (algorithm < 0) {
+                std::fprintf(stderr, "Unknown algorithm '%s'\n", argv[i]);
+                printUsage(argv[0]);
+                return 2;
+            }
+        } else if (arg == "--jobs" && hasValue) {
+            jobs = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--out" && hasValue) {
+            outputDir = argv[++i];
+        } else if (arg == "--queries" && hasValue) {
+            queriesFile = argv[++i];
+        } else if (arg == "--edits" && hasValue) {
+            editsFile = argv[++i];
+        } else if (arg == "--pairs" && hasValue) {
+            pairsFile = argv[++i];
+        } else if (arg == "--trace" && hasValue) {
+            traceFile = argv[++i];
+        } else if (arg == "--cache-mb" && hasValue) {
+            cacheMb = static_cast<std::size_t>(std::max(1, std::atoi(argv[++i])));
+        } else if (arg == "--cluster" && hasValue) {
+            setHpaClusterSize(std::atoi(argv[++i]));
+        } else if (arg == "--no-path") {
+            printPath = false;
+        } else {
+            printUsage(argv[0]);
+            return arg == "--help" || arg == "-h" ? 0 : 2;
+        }
+    }
+
+    if (solveFile.empty() == batchSource.empty()) {
+        printUsage(argv[0]);
+        return 2;
+    }
+    if (!solveFile.empty() && !queriesFile.empty()) {
+        return answerQueries(solveFile, queriesFile);
+    }
+    if (!solveFile.empty() && !editsFile.empty()) {
+        return replanEdits(solveFile, editsFile);
+    }
+    if (!solveFile.empty() && !pairsFile.empty()) {
+        return solvePairs(solveFile, pairsFile, algorithm, jobs);
+    }
+    if (!solveFile.empty() && !traceFile.empty()) {
+        return recordTrace(solveFile, algorithm, traceFile);
+    }
+    if (!solveFile.empty() && isTiledMaze(solveFile)) {
+        return solveTiled(solveFile, availableAlgorithms()[algorithm].key, cacheMb, printPath);
+    }
+    if (!solveFile.empty()) {
+        return solveOne(solveFile, algorithm, printPath);
+    }
+
+    BatchOptions options;
+    if (!collectBatchMazes(batchSource, options.mazes)) {
+        return 2;
+    }
+    options.algorithm = algorithm;
+    options.jobs = jobs;
+    options.outputDir = outputDir;
+    return runBatch(options, stdout) == 0 ? 0 : 1;
+}
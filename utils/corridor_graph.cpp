@@ -0,0 +1,103 @@
+#include "../include/corridor_graph.h"
+#include <algorithm>
+
+namespace {
+
+bool isEndpoint(const Grid& maze, int id) {
+    return maze[id] == CELL_START || maze[id] == CELL_END;
+}
+
+} // namespace
+
+CorridorGraph::CorridorGraph(const Grid& maze) : cells_(maze.cellCount(), 0), openCells_(0), filledCells_(0) {
+    std::vector<int> deadEnds;
+    for (int y = 0; y < maze.height(); ++y) {
+        for (int id = maze.index(0, y), rowEnd = maze.index(maze.width(), y); id < rowEnd; ++id) {
+            if (maze[id] == CELL_WALL) {
+                continue;
+            }
+            cells_[id] = static_cast<std::uint8_t>(kKeptCell | maze.openMask(id));
+            ++openCells_;
+            if (__builtin_popcount(maze.openMask(id)) <= 1 && !isEndpoint(maze, id)) {
+                deadEnds.push_back(id);
+            }
+        }
+    }
+
+    // Fill dead ends until none are left; each filled cell may leave its
+    // one neighbour as a new dead end
+    while (!deadEnds.empty()) {
+        int id = deadEnds.back();
+        deadEnds.pop_back();
+        unsigned mask = keptMask(id);
+        cells_[id] = 0;
+        ++filledCells_;
+        for (int d = 0; d < 4; ++d) {
+            if (!(mask & (1u << d))) {
+                continue;
+            }
+            int neighbour = id + maze.offset(d);
+            cells_[neighbour] &= static_cast<std::uint8_t>(~(1u << (d ^ 1)));
+            if (__builtin_popcount(keptMask(neighbour)) == 1 && !isEndpoint(maze, neighbour)) {
+                deadEnds.push_back(neighbour);
+            }
+        }
+    }
+
+    for (int y = 0; y < maze.height(); ++y) {
+        for (int id = maze.index(0, y), rowEnd = maze.index(maze.width(), y); id < rowEnd; ++id) {
+            if (kept(id) && (__builtin_popcount(keptMask(id)) != 2 || isEndpoint(maze, id))) {
+                cells_[id] |= kJunctionCell;
+                junctionCells_.push_back(id);
+            }
+        }
+    }
+
+    // One edge per corridor end; corridors looping back to their junction
+    // never shorten a path and are left out
+    edgeStart_.assign(junctionCells_.size() + 1, 0);
+    for (std::size_t junction = 0; junction < junctionCells_.size(); ++junction) {
+        int id = junctionCells_[junction];
+        unsigned mask = keptMask(id);
+        for (int d = 0; d < 4; ++d) {
+            if (!(mask & (1u << d))) {
+                continue;
+            }
+            int cost = 0;
+            int target = walk(maze, id, d, -1, cost);
+            if (target == id) {
+                continue;
+            }
+            edgeTargets_.push_back(junctionAt(target));
+            edgeCosts_.push_back(cost);
+            edgeDirections_.push_back(static_cast<std::uint8_t>(d));
+        }
+        edgeStart_[junction + 1] = static_cast<int>(edgeTargets_.size());
+    }
+}
+
+int CorridorGraph::walk(const Grid& maze, int from, int d, int stop, int& cost) const {
+    int id = from + maze.offset(d);
+    cost = 1;
+    while (!isJunction(id) && id != stop && id != from) {
+        // A corridor cell has one way on besides the way back
+        d = __builtin_ctz(keptMask(id) & ~(1u << (d ^ 1)));
+        id += maze.offset(d);
+        ++cost;
+    }
+    return id;
+}
+
+int CorridorGraph::junctionAt(int id) const {
+    std::vector<int>::const_iterator found = std::lower_bound(junctionCells_.begin(), junctionCells_.end(), id);
+    if (found == junctionCells_.end() || *found != id) {
+        return -1;
+    }
+    return static_cast<int>(found - junctionCells_.begin());
+}
+
+std::size_t CorridorGraph::memoryBytes() const {
+    return cells_.capacity() + edgeDirections_.capacity() +
+           (junctionCells_.capacity() + edgeStart_.capacity() + edgeTargets_.capacity() + edgeCosts_.capacity()) *
+               sizeof(int);
+}
@@ -0,0 +1,163 @@
+#include "../include/d_star_lite.h"
+#include "../include/algorithms.h"
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+
+namespace {
+
+const int kUnreached = std::numeric_limits<int>::max();
+
+} // namespace
+
+DStarLite::DStarLite(const Grid& maze, int startId, int endId, MemoryCounter* cellCounter,
+                     MemoryCounter* frontierCounter)
+    : maze_(maze), startId_(startId), endId_(endId), start_(maze.coordinates(startId)),
+      g_(maze.cellCount(), kUnreached, IntArray::allocator_type(cellCounter)),
+      rhs_(maze.cellCount(), kUnreached, IntArray::allocator_type(cellCounter)),
+      queuedKey_(maze.cellCount(), -1, IntArray::allocator_type(cellCounter)),
+      open_(TIES_LARGER_SECONDARY, frontierCounter), pushes_(0) {
+    rhs_[endId_] = 0;
+    updateCell(endId_);
+}
+
+int DStarLite::heuristic(int id) const {
+    Coordinates position = maze_.coordinates(id);
+    return std::abs(position.first - start_.first) + std::abs(position.second - start_.second);
+}
+
+int DStarLite::lookahead(int id) const {
+    int best = kUnreached;
+    unsigned moves = maze_.openMask(id);
+    for (int d = 0; d < 4; ++d) {
+        int next = id + maze_.offset(d);
+        if ((moves & (1u << d)) && g_[next] != kUnreached) {
+            best = std::min(best, g_[next] + 1);
+        }
+    }
+    return best;
+}
+
+// Queue an inconsistent cell under its current key, or drop a consistent
+// one. Old entries stay behind and are skipped when popped.
+void DStarLite::updateCell(int id) {
+    if (g_[id] == rhs_[id]) {
+        queuedKey_[id] = -1;
+        return;
+    }
+    int key = std::min(g_[id], rhs_[id]);
+    if (queuedKey_[id] == key) {
+        return;
+    }
+    queuedKey_[id] = key;
+    // Keys are (min(g, rhs) + h, min(g, rhs)); ties on the first go to the
+    // smaller second
+    open_.push(key + heuristic(id), id, -key);
+    ++pushes_;
+}
+
+bool DStarLite::plan(SearchObserver& observer, int& openedNodes) {
+    while (!open_.empty()) {
+        int key = open_.minKey();
+        int id = open_.top();
+        if (queuedKey_[id] < 0 || queuedKey_[id] + heuristic(id) != key) {
+            open_.pop();
+            continue;
+        }
+        // Done once the start is consistent and no queued key sorts before
+        // its key, (g, g) as h is 0 there
+        int startKey = std::min(g_[startId_], rhs_[startId_]);
+        if (g_[startId_] == rhs_[startId_] &&
+            (key > startKey || (key == startKey && queuedKey_[id] >= startKey))) {
+            break;
+        }
+        open_.pop();
+        queuedKey_[id] = -1;
+        openedNodes++;
+
+        unsigned moves = maze_.openMask(id);
+        if (g_[id] > rhs_[id]) {
+            // Overconsistent: settle g and offer it to the neighbours
+            g_[id] = rhs_[id];
+            for (int d = 0; d < 4; ++d) {
+                int next = id + maze_.offset(d);
+                if ((moves & (1u << d)) && next != endId_ && g_[id] + 1 < rhs_[next]) {
+                    rhs_[next] = g_[id] + 1;
+                    updateCell(next);
+                }
+            }
+        } else {
+            // Underconsistent: the old g is gone, so neighbours that relied
+            // on it look for another way, and the cell is queued again
+            int oldG = g_[id];
+            g_[id] = kUnreached;
+            for (int d = 0; d < 4; ++d) {
+                int next = id + maze_.offset(d);
+                if ((moves & (1u << d)) && next != endId_ && rhs_[next] == oldG + 1) {
+                    rhs_[next] = lookahead(next);
+                    updateCell(next);
+                }
+            }
+            updateCell(id);
+        }
+
+        if (!observer.onExpand(maze_, id, openedNodes)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void DStarLite::cellChanged(int id) {
+    if (maze_[id] == CELL_WALL) {
+        g_[id] = kUnreached;
+        rhs_[id] = kUnreached;
+        queuedKey_[id] = -1;
+    } else {
+        rhs_[id] = lookahead(id);
+        updateCell(id);
+    }
+    // The cell's neighbours gained or lost a way through it
+    for (int d = 0; d < 4; ++d) {
+        int next = id + maze_.offset(d);
+        if (maze_[next] != CELL_WALL && next != endId_) {
+            rhs_[next] = lookahead(next);
+            updateCell(next);
+        }
+    }
+}
+
+bool DStarLite::pathExists() const {
+    return g_[startId_] != kUnreached;
+}
+
+bool DStarLite::path(std::vector<Coordinates>& path) const {
+    path.clear();
+    if (!pathExists()) {
+        return false;
+    }
+    path.reserve(g_[startId_] + 1);
+    path.push_back(start_);
+    // Downhill on g: every cell on a shortest path was settled by plan()
+    for (int id = startId_; id != endId_;) {
+        int next = -1;
+        unsigned moves = maze_.openMask(id);
+        for (int d = 0; d < 4; ++d) {
+            int neighbour = id + maze_.offset(d);
+            if ((moves & (1u << d)) && g_[neighbour] < (next < 0 ? g_[id] : g_[next])) {
+                next = neighbour;
+            }
+        }
+        if (next < 0) {
+            path.clear();
+            return false;
+        }
+        id = next;
+        path.push_back(maze_.coordinates(id));
+    }
+    return true;
+}
+
+std::size_t DStarLite::memoryBytes() const {
+    return (g_.capacity() + rhs_.capacity() + queuedKey_.capacity()) * sizeof(int) + open_.memoryBytes();
+}
@@ -0,0 +1,153 @@
+#include "../include/distance_field.h"
+#include <cstdio>
+
+DistanceField::DistanceField(const Grid& maze, int goalId) : goalId_(goalId), distances_(maze.cellCount(), -1) {
+    std::vector<int> queue;
+    queue.reserve(static_cast<std::size_t>(maze.width()) * maze.height());
+    queue.push_back(goalId);
+    distances_[goalId] = 0;
+    for (std::size_t head = 0; head < queue.size(); ++head) {
+        int current = queue[head];
+        int next = distances_[current] + 1;
+        unsigned open = maze.openMask(current);
+        for (int d = 0; d < 4; ++d) {
+            int neighbour = current + maze.offset(d);
+            if ((open & (1u << d)) && distances_[neighbour] < 0) {
+                distances_[neighbour] = next;
+                queue.push_back(neighbour);
+            }
+        }
+    }
+}
+
+bool DistanceField::path(const Grid& maze, int startId, std::vector<Coordinates>& path) const {
+    path.clear();
+    int id = startId;
+    if (distances_[id] < 0) {
+        return false;
+    }
+    path.reserve(distances_[id] + 1);
+    while (distances_[id] > 0) {
+        path.push_back(maze.coordinates(id));
+        // Step to the first neighbour one move closer, in direction order
+        unsigned open = maze.openMask(id);
+        for (int d = 0; d < 4; ++d) {
+            int next = id + maze.offset(d);
+            if ((open & (1u << d)) && distances_[next] == distances_[id] - 1) {
+                id = next;
+                break;
+            }
+        }
+    }
+    path.push_back(maze.coordinates(id));
+    return true;
+}
+
+DistanceFieldCache::DistanceFieldCache(std::size_t budgetBytes)
+    : budgetBytes_(budgetBytes), usedBytes_(0), hits_(0), misses_(0), evictions_(0) {}
+
+std::shared_ptr<const DistanceField> DistanceFieldCache::field(const std::string& mazeKey, const Grid& maze, int goalId) {
+    Key key(mazeKey, goalId);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::map<Key, std::list<Entry>::iterator>::iterator found = index_.find(key);
+        if (found != index_.end()) {
+            ++hits_;
+            entries_.splice(entries_.begin(), entries_, found->second);
+            return found->second->second;
+        }
+        ++misses_;
+    }
+
+    // Built outside the lock so other goals stay available meanwhile; two
+    // threads missing on the same goal both build it and the first is kept
+    std::shared_ptr<const DistanceField> built = std::make_shared<DistanceField>(maze, goalId);
+    std::size_t bytes = built->memoryBytes();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::map<Key, std::list<Entry>::iterator>::iterator found = index_.find(key);
+    if (found != index_.end()) {
+        return found->second->second;
+    }
+    if (bytes > budgetBytes_) {
+        return built;
+    }
+    evictTo(budgetBytes_ - bytes);
+    entries_.push_front(Entry(key, built));
+    index_[key] = entries_.begin();
+    usedBytes_ += bytes;
+    return built;
+}
+
+std::shared_ptr<const DistanceField> DistanceFieldCache::cached(const std::string& mazeKey, int goalId) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::map<Key, std::list<Entry>::iterator>::iterator found = index_.find(Key(mazeKey, goalId));
+    if (found == index_.end()) {
+        return nullptr;
+    }
+    ++hits_;
+    entries_.splice(entries_.begin(), entries_, found->second);
+    return found->second->second;
+}
+
+bool DistanceFieldCache::findPath(const std::string& mazeKey, const Grid& maze, const Coordinates& start,
+                                  const Coordinates& goal, std::vector<Coordinates>& path) {
+    return field(mazeKey, maze, maze.index(goal))->path(maze, maze.index(start), path);
+}
+
+void DistanceFieldCache::evictTo(std::size_t budgetBytes) {
+    while (usedBytes_ > budgetBytes && !entries_.empty()) {
+        usedBytes_ -= entries_.back().second->memoryBytes();
+        index_.erase(entries_.back().first);
+        entries_.pop_back();
+        ++evictions_;
+    }
+}
+
+void DistanceFieldCache::erase(const std::string& mazeKey) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::map<Key, std::list<Entry>::iterator>::iterator it = index_.lower_bound(Key(mazeKey, -1));
+    while (it != index_.end() && it->first.first == mazeKey) {
+        usedBytes_ -= it->second->second->memoryBytes();
+        entries_.erase(it->second);
+        index_.erase(it++);
+    }
+}
+
+void DistanceFieldCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    index_.clear();
+    usedBytes_ = 0;
+}
+
+std::size_t DistanceFieldCache::memoryBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return usedBytes_;
+}
+
+long long DistanceFieldCache::hits() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+}
+
+long long DistanceFieldCache::misses() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+}
+
+long long DistanceFieldCache::evictions() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return evictions_;
+}
+
+std::string distanceFieldKey(const std::string& mazeName, std::uint64_t contentHash) {
+    char hash[17];
+    std::snprintf(hash, sizeof(hash), "%016llx", static_cast<unsigned long long>(contentHash));
+    return mazeName + "#" + hash;
+}
+
+DistanceFieldCache& sharedDistanceFieldCache() {
+    static DistanceFieldCache cache(kDefaultDistanceFieldBytes);
+    return cache;
+}
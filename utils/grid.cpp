@@ -0,0 +1,150 @@
+#include "../include/grid.h"
+#include "../include/abstract_graph.h"
+#include "../include/binary_maze.h"
+#include "../include/corridor_graph.h"
+#include "../include/jump_table.h"
+#include <algorithm>
+#include <cassert>
+
+Grid::Grid() : width_(0), height_(0), stride_(0), offsets_{0, 0, 0, 0} {}
+
+Grid::Grid(int width, int height)
+    : width_(width), height_(height), stride_(width + 2),
+      offsets_{-1, 1, -(width + 2), width + 2},
+      cells_(static_cast<std::size_t>(width + 2) * (height + 2), CELL_PATH),
+      masks_(cells_.size(), 0) {
+    assert(fits(width, height));
+    // Wall border: top and bottom padding rows, then the side columns
+    std::fill(cells_.begin(), cells_.begin() + stride_, CELL_WALL);
+    std::fill(cells_.end() - stride_, cells_.end(), CELL_WALL);
+    for (int y = 0; y < height_; ++y) {
+        cells_[index(-1, y)] = CELL_WALL;
+        cells_[index(width_, y)] = CELL_WALL;
+    }
+}
+
+void Grid::setWalls(const WallBitmap& walls, int firstRow, int lastRow) {
+    setWalls(walls.words().data(), walls.wordsPerRow(), firstRow, lastRow);
+}
+
+void Grid::setWalls(const std::uint64_t* words, int wordsPerRow, int firstRow, int lastRow) {
+    // Bits past the last column are ignored
+    int lastWord = (width_ - 1) >> 6;
+    int usedWords = std::min(wordsPerRow, lastWord + 1);
+    std::uint64_t lastWordMask = (width_ & 63) ? (std::uint64_t(1) << (width_ & 63)) - 1 : ~std::uint64_t(0);
+    for (int y = firstRow; y < lastRow; ++y) {
+        std::int8_t* row = &cells_[index(0, y)];
+        const std::uint64_t* bits = words + static_cast<std::size_t>(y) * wordsPerRow;
+        for (int w = 0; w < usedWords; ++w) {
+            std::uint64_t word = bits[w];
+            if (w == lastWord) {
+                word &= lastWordMask;
+            }
+            // Visit only the set bits of each word
+            for (; word != 0; word &= word - 1) {
+                row[w * 64 + __builtin_ctzll(word)] = CELL_WALL;
+            }
+        }
+    }
+}
+
+WallBitmap Grid::walls() const {
+    WallBitmap bitmap(width_, height_);
+    for (int y = 0; y < height_; ++y) {
+        const std::int8_t* row = &cells_[index(0, y)];
+        std::uint64_t* bits = bitmap.row(y);
+        for (int x = 0; x < width_; ++x) {
+            bits[x >> 6] |= static_cast<std::uint64_t>(row[x] == CELL_WALL) << (x & 63);
+        }
+    }
+    return bitmap;
+}
+
+void Grid::computeNeighbourMasks() {
+    jumpTable_.reset();
+    abstractGraph_.reset();
+    corridorGraph_.reset();
+    computeNeighbourMasks(0, height_);
+}
+
+void Grid::computeNeighbourMasks(int firstRow, int lastRow) {
+    // Locals, so stores through the uint8_t mask pointer cannot alias them
+    const int width = width_;
+    for (int y = firstRow; y < lastRow; ++y) {
+        // Branch-free so the compiler can vectorise the row
+        const std::int8_t* row = &cells_[index(0, y)];
+        const std::int8_t* above = row - stride_;
+        const std::int8_t* below = row + stride_;
+        std::uint8_t* masks = &masks_[index(0, y)];
+        for (int x = 0; x < width; ++x) {
+            masks[x] = static_cast<std::uint8_t>((row[x - 1] != CELL_WALL) |
+                                                 ((row[x + 1] != CELL_WALL) << 1) |
+                                                 ((above[x] != CELL_WALL) << 2) |
+                                                 ((below[x] != CELL_WALL) << 3));
+        }
+    }
+}
+
+void Grid::setWall(int id, bool wall) {
+    jumpTable_.reset();
+    abstractGraph_.reset();
+    corridorGraph_.reset();
+    cells_[id] = wall ? CELL_WALL : CELL_PATH;
+
+    // Only the cell and the neighbours' bits pointing at it change; the
+    // border keeps no masks
+    std::uint8_t mask = 0;
+    for (int d = 0; d < 4; ++d) {
+        int neighbour = id + offsets_[d];
+        mask |= static_cast<std::uint8_t>((cells_[neighbour] != CELL_WALL) << d);
+        Coordinates position = coordinates(neighbour);
+        if (position.first < 0 || position.first >= width_ || position.second < 0 || position.second >= height_) {
+            continue;
+        }
+        std::uint8_t back = static_cast<std::uint8_t>(1u << (d ^ 1));
+        masks_[neighbour] = static_cast<std::uint8_t>(wall ? masks_[neighbour] & ~back : masks_[neighbour] | back);
+    }
+    masks_[id] = mask;
+}
+
+void Grid::buildJumpTable() {
+    jumpTable_ = std::make_shared<JumpTable>(*this);
+}
+
+void Grid::buildCorridorGraph() {
+    corridorGraph_ = std::make_shared<CorridorGraph>(*this);
+}
+
+MemoryUsage Grid::memoryUsage() const {
+    MemoryUsage usage;
+    usage.bytes = cells_.capacity() * sizeof(std::int8_t) + masks_.capacity() * sizeof(std::uint8_t);
+    usage.allocations = 2;
+    if (jumpTable_) {
+        usage.bytes += jumpTable_->memoryBytes();
+        ++usage.allocations;
+    }
+    if (abstractGraph_) {
+        usage.bytes += abstractGraph_->memoryBytes();
+        ++usage.allocations;
+    }
+    if (corridorGraph_) {
+        usage.bytes += corridorGraph_->memoryBytes();
+        ++usage.allocations;
+    }
+    usage.peakBytes = usage.bytes;
+    return usage;
+}
+
+void Grid::buildAbstractGraph(const std::string& cacheFile, int clusterSize) {
+    if (cacheFile.empty()) {
+        abstractGraph_ = std::make_shared<AbstractGraph>(*this, clusterSize);
+        return;
+    }
+    std::uint64_t contentHash = hashWalls(walls());
+    std::shared_ptr<AbstractGraph> graph = AbstractGraph::load(cacheFile, *this, contentHash, clusterSize);
+    if (!graph) {
+        graph = std::make_shared<AbstractGraph>(*this, clusterSize);
+        graph->save(cacheFile, contentHash);
+    }
+    abstractGraph_ = graph;
+}
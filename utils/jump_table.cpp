@@ -0,0 +1,47 @@
+#include "../include/jump_table.h"
+
+namespace {
+
+const int LEFT = 0;
+const int RIGHT = 1;
+const int UP = 2;
+const int DOWN = 3;
+
+} // namespace
+
+JumpTable::JumpTable(const Grid& maze) : distances_(static_cast<std::size_t>(maze.cellCount()) * 4, 0) {
+    // Every distance extends the one of the next cell in the same direction,
+    // so each direction is swept from the side it runs into. Vertical
+    // distances go first: horizontal jump points are defined by them.
+    const int width = maze.width();
+    const int height = maze.height();
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            scan(maze, maze.index(x, y), UP);
+        }
+    }
+    for (int y = height - 1; y >= 0; --y) {
+        for (int x = 0; x < width; ++x) {
+            scan(maze, maze.index(x, y), DOWN);
+        }
+    }
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            scan(maze, maze.index(x, y), LEFT);
+        }
+        for (int x = width - 1; x >= 0; --x) {
+            scan(maze, maze.index(x, y), RIGHT);
+        }
+    }
+}
+
+void JumpTable::scan(const Grid& maze, int id, int d) {
+    if (maze[id] == CELL_WALL || !(maze.openMask(id) & (1u << d))) {
+        return;
+    }
+    int next = id + maze.offset(d);
+    bool jumpPoint = d >= UP ? forcedNeighbours(maze, next, d) != 0
+                             : distance(next, UP) > 0 || distance(next, DOWN) > 0;
+    int rest = distance(next, d);
+    at(id, d) = jumpPoint ? 1 : (rest > 0 ? rest + 1 : rest - 1);
+}
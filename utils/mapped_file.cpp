@@ -0,0 +1,50 @@
+#include "../include/mapped_file.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile() : fd_(-1), data_(nullptr), size_(0) {}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const std::string& filename) {
+    close();
+    fd_ = ::open(filename.c_str(), O_RDONLY);
+    if (fd_ < 0) {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd_, &info) != 0) {
+        close();
+        return false;
+    }
+    size_ = static_cast<std::size_t>(info.st_size);
+    if (size_ == 0) {
+        return true;  // Nothing to map, but the file exists
+    }
+
+    void* mapping = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+    if (mapping == MAP_FAILED) {
+        close();
+        return false;
+    }
+    madvise(mapping, size_, MADV_SEQUENTIAL);
+    data_ = static_cast<const char*>(mapping);
+    return true;
+}
+
+void MappedFile::close() {
+    if (data_ != nullptr) {
+        munmap(const_cast<char*>(data_), size_);
+        data_ = nullptr;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    size_ = 0;
+}
@@ -0,0 +1,157 @@
+#include "../include/maze_cache.h"
+#include "../include/binary_maze.h"
+#include "../include/maze_loader.h"
+#include <algorithm>
+#include <sys/stat.h>
+
+MazeCache::MazeCache(std::size_t budgetBytes)
+    : budgetBytes_(budgetBytes), usedBytes_(0), hits_(0), misses_(0), evictions_(0) {}
+
+bool MazeCache::stampOf(const std::string& filename, FileStamp& stamp) {
+    struct stat info;
+    if (stat(filename.c_str(), &info) != 0) {
+        return false;
+    }
+#if defined(__APPLE__)
+    const struct timespec& modified = info.st_mtimespec;
+#else
+    const struct timespec& modified = info.st_mtim;
+#endif
+    stamp.modifiedNs = static_cast<std::int64_t>(modified.tv_sec) * 1000000000 + modified.tv_nsec;
+    stamp.size = static_cast<std::int64_t>(info.st_size);
+    return true;
+}
+
+std::shared_ptr<const CachedMaze> MazeCache::load(const std::string& filename, const AlgorithmInfo* algorithm) {
+    std::vector<const AlgorithmInfo*> algorithms;
+    if (algorithm != nullptr) {
+        algorithms.push_back(algorithm);
+    }
+    return load(filename, algorithms);
+}
+
+std::shared_ptr<const CachedMaze> MazeCache::load(const std::string& filename,
+                                                  const std::vector<const AlgorithmInfo*>& algorithms) {
+    FileStamp stamp;
+    bool stamped = stampOf(filename, stamp);
+    std::shared_ptr<const CachedMaze> cached;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::map<std::string, std::list<Entry>::iterator>::iterator found = index_.find(filename);
+        if (found != index_.end() && stamped && found->second->stamp == stamp) {
+            ++hits_;
+            entries_.splice(entries_.begin(), entries_, found->second);
+            cached = found->second->maze;
+        } else {
+            ++misses_;
+        }
+    }
+
+    std::shared_ptr<CachedMaze> built;
+    if (!cached) {
+        // Read outside the lock so other mazes stay available meanwhile
+        built = std::make_shared<CachedMaze>();
+        built->maze = readMaze(filename, built->start, built->end);
+        if (built->maze.empty()) {
+            erase(filename);
+            return nullptr;
+        }
+        built->contentHash = hashWalls(built->maze.walls());
+    } else if (std::all_of(algorithms.begin(), algorithms.end(), [&](const AlgorithmInfo* algorithm) {
+                   return algorithm->prepare == nullptr ||
+                          std::find(cached->prepared.begin(), cached->prepared.end(), algorithm->prepare) !=
+                              cached->prepared.end();
+               })) {
+        return cached;
+    } else {
+        // Callers may still be copying the cached maze, so it is prepared
+        // as a new entry rather than in place
+        built = std::make_shared<CachedMaze>(*cached);
+    }
+    for (const AlgorithmInfo* algorithm : algorithms) {
+        MazePreparation preparation = algorithm->prepare;
+        if (preparation != nullptr &&
+            std::find(built->prepared.begin(), built->prepared.end(), preparation) == built->prepared.end()) {
+            prepareMaze(*algorithm, built->maze, filename);
+            built->prepared.push_back(preparation);
+        }
+    }
+
+    // A file that vanished while being read is not kept
+    if (stamped) {
+        Entry entry;
+        entry.filename = filename;
+        entry.stamp = stamp;
+        entry.maze = built;
+        entry.bytes = built->maze.memoryUsage().bytes;
+        insert(entry);
+    }
+    return built;
+}
+
+void MazeCache::insert(const Entry& entry) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    eraseLocked(entry.filename);
+    if (entry.bytes > budgetBytes_) {
+        return;
+    }
+    evictTo(budgetBytes_ - entry.bytes);
+    entries_.push_front(entry);
+    index_[entry.filename] = entries_.begin();
+    usedBytes_ += entry.bytes;
+}
+
+void MazeCache::evictTo(std::size_t budgetBytes) {
+    while (usedBytes_ > budgetBytes && !entries_.empty()) {
+        usedBytes_ -= entries_.back().bytes;
+        index_.erase(entries_.back().filename);
+        entries_.pop_back();
+        ++evictions_;
+    }
+}
+
+void MazeCache::erase(const std::string& filename) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    eraseLocked(filename);
+}
+
+void MazeCache::eraseLocked(const std::string& filename) {
+    std::map<std::string, std::list<Entry>::iterator>::iterator found = index_.find(filename);
+    if (found != index_.end()) {
+        usedBytes_ -= found->second->bytes;
+        entries_.erase(found->second);
+        index_.erase(found);
+    }
+}
+
+void MazeCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    index_.clear();
+    usedBytes_ = 0;
+}
+
+std::size_t MazeCache::memoryBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return usedBytes_;
+}
+
+long long MazeCache::hits() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+}
+
+long long MazeCache::misses() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+}
+
+long long MazeCache::evictions() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return evictions_;
+}
+
+MazeCache& sharedMazeCache() {
+    static MazeCache cache(kDefaultMazeCacheBytes);
+    return cache;
+}
@@ -0,0 +1,598 @@
+#include "../include/maze_generator.h"
+#include "../include/parallel.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <numeric>
+#include <vector>
+
+namespace {
+
+const int kRowsPerChunk = 256;
+
+// Smoothing passes of the cave automaton
+const int kCaveRounds = 4;
+
+const char* const kStyleNames[] = {"backtracker", "kruskal", "prim", "wilson", "cave", "eller"};
+
+// SplitMix64 with its own integer mapping, so a seed gives the same maze
+// whatever the standard library (its distributions are not portable)
+class Random {
+public:
+    explicit Random(std::uint64_t seed) : state_(seed) {}
+
+    std::uint64_t next() {
+        std::uint64_t z = (state_ += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    /// Uniform in [0, n)
+    int below(int n) { return static_cast<int>(((next() >> 32) * static_cast<std::uint64_t>(n)) >> 32); }
+
+    /// True with probability p
+    bool chance(double p) { return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0) < p; }
+
+private:
+    std::uint64_t state_;
+};
+
+// Visits [0, count) in a seeded random order without storing it: a keyed
+// bijection on the next power of two, applied again while the value lies
+// outside the range (cycle walking), which keeps it a bijection on the range
+class RandomOrder {
+public:
+    RandomOrder(std::uint64_t count, Random& random) : count_(count), bits_(0) {
+        while ((std::uint64_t(1) << bits_) < count) {
+            ++bits_;
+        }
+        mask_ = (std::uint64_t(1) << bits_) - 1;
+        for (int round = 0; round < kRounds; ++round) {
+            multipliers_[round] = random.next() | 1;
+            increments_[round] = random.next();
+        }
+    }
+
+    std::uint64_t operator[](std::uint64_t index) const {
+        do {
+            index = mix(index);
+        } while (index >= count_);
+        return index;
+    }
+
+private:
+    static const int kRounds = 4;
+
+    // Odd multiplies and right xorshifts are both invertible on bits_ bits
+    std::uint64_t mix(std::uint64_t x) const {
+        for (int round = 0; round < kRounds; ++round) {
+            x = (x * multipliers_[round] + increments_[round]) & mask_;
+            x ^= x >> (bits_ / 2 + 1);
+        }
+        return x;
+    }
+
+    std::uint64_t count_;
+    int bits_;
+    std::uint64_t mask_;
+    std::uint64_t multipliers_[kRounds];
+    std::uint64_t increments_[kRounds];
+};
+
+// Rooms of the room styles: room (i, j) is the cell (2i + 1, 2j + 1) and
+// the cell between two neighbouring rooms is the wall separating them.
+// Directions are those of `directions`.
+class RoomLayout {
+public:
+    explicit RoomLayout(WallBitmap& walls)
+        : walls_(walls), cols_((walls.width() - 1) / 2), rows_((walls.height() - 1) / 2) {}
+
+    int cols() const { return cols_; }
+    int rows() const { return rows_; }
+    int count() const { return cols_ * rows_; }
+
+    /// Directions (bit d) in which room has a neighbouring room
+    unsigned neighbourMask(int room) const {
+        int x = room % cols_;
+        int y = room / cols_;
+        return (x > 0) | ((x + 1 < cols_) << 1) | ((y > 0) << 2) | ((y + 1 < rows_) << 3);
+    }
+
+    int neighbour(int room, int d) const { return room + directions[d].first + directions[d].second * cols_; }
+
+    bool walled(int room, int d) const { return walls_.isWall(wallX(room, d), wallY(room, d)); }
+
+    /// Remove the wall between room and its neighbour in direction d
+    void carve(int room, int d) { walls_.clearWall(wallX(room, d), wallY(room, d)); }
+
+private:
+    int wallX(int room, int d) const { return 2 * (room % cols_) + 1 + directions[d].first; }
+    int wallY(int room, int d) const { return 2 * (room / cols_) + 1 + directions[d].second; }
+
+    WallBitmap& walls_;
+    int cols_;
+    int rows_;
+};
+
+const std::uint8_t kNoDirection = 4;
+
+// Random walk that goes back along its own trail at dead ends. The trail
+// is kept as the direction back out of each room rather than a stack.
+void carveBacktracker(RoomLayout& rooms, Random& random) {
+    std::vector<bool> visited(rooms.count(), false);
+    std::vector<std::uint8_t> back(rooms.count(), kNoDirection);
+    int current = random.below(rooms.count());
+    visited[current] = true;
+    while (true) {
+        int choices[4];
+        int count = 0;
+        unsigned mask = rooms.neighbourMask(current);
+        for (int d = 0; d < 4; ++d) {
+            if ((mask & (1u << d)) && !visited[rooms.neighbour(current, d)]) {
+                choices[count++] = d;
+            }
+        }
+        if (count > 0) {
+            int d = choices[random.below(count)];
+            rooms.carve(current, d);
+            current = rooms.neighbour(current, d);
+            visited[current] = true;
+            back[current] = static_cast<std::uint8_t>(d ^ 1);
+        } else if (back[current] == kNoDirection) {
+            break;
+        } else {
+            current = rooms.neighbour(current, back[current]);
+        }
+    }
+}
+
+// Walls in random order, each removed when the rooms on either side are
+// not connected yet (union-find with path halving)
+void carveKruskal(RoomLayout& rooms, Random& random) {
+    std::vector<int> parent(rooms.count());
+    std::iota(parent.begin(), parent.end(), 0);
+    auto find = [&](int room) {
+        while (parent[room] != room) {
+            parent[room] = parent[parent[room]];
+            room = parent[room];
+        }
+        return room;
+    };
+
+    // Walls to the right of a room first, then those below
+    std::uint64_t across = static_cast<std::uint64_t>(rooms.cols() - 1) * rooms.rows();
+    std::uint64_t walls = across + static_cast<std::uint64_t>(rooms.cols()) * (rooms.rows() - 1);
+    RandomOrder order(walls, random);
+    int joins = rooms.count() - 1;
+    for (std::uint64_t i = 0; i < walls && joins > 0; ++i) {
+        std::uint64_t wall = order[i];
+        int room, d;
+        if (wall < across) {
+            room = static_cast<int>(wall / (rooms.cols() - 1) * rooms.cols() + wall % (rooms.cols() - 1));
+            d = 1;
+        } else {
+            room = static_cast<int>(wall - across);
+            d = 3;
+        }
+        int a = find(room);
+        int b = find(rooms.neighbour(room, d));
+        if (a != b) {
+            parent[a] = b;
+            rooms.carve(room, d);
+            --joins;
+        }
+    }
+}
+
+// Grows one tree: a random frontier room is joined to a random neighbour
+// already in the maze
+void carvePrim(RoomLayout& rooms, Random& random) {
+    std::vector<bool> inMaze(rooms.count(), false);
+    std::vector<bool> queued(rooms.count(), false);
+    std::vector<int> frontier;
+    auto add = [&](int room) {
+        inMaze[room] = true;
+        unsigned mask = rooms.neighbourMask(room);
+        for (int d = 0; d < 4; ++d) {
+            int next = rooms.neighbour(room, d);
+            if ((mask & (1u << d)) && !inMaze[next] && !queued[next]) {
+                queued[next] = true;
+                frontier.push_back(next);
+            }
+        }
+    };
+
+    add(random.below(rooms.count()));
+    while (!frontier.empty()) {
+        std::size_t pick = random.below(static_cast<int>(frontier.size()));
+        int room = frontier[pick];
+        frontier[pick] = frontier.back();
+        frontier.pop_back();
+
+        int choices[4];
+        int count = 0;
+        unsigned mask = rooms.neighbourMask(room);
+        for (int d = 0; d < 4; ++d) {
+            if ((mask & (1u << d)) && inMaze[rooms.neighbour(room, d)]) {
+                choices[count++] = d;
+            }
+        }
+        rooms.carve(room, choices[random.below(count)]);
+        add(room);
+    }
+}
+
+// Random walks from each room outside the tree until they hit it; the last
+// exit taken from each room erases the walk's loops, and the walk is then
+// added to the tree along those exits
+void carveWilson(RoomLayout& rooms, Random& random) {
+    std::vector<bool> inTree(rooms.count(), false);
+    std::vector<std::uint8_t> exits(rooms.count(), kNoDirection);
+    inTree[random.below(rooms.count())] = true;
+    for (int first = 0; first < rooms.count(); ++first) {
+        int room = first;
+        while (!inTree[room]) {
+            unsigned mask = rooms.neighbourMask(room);
+            int d;
+            do {
+                d = random.below(4);
+            } while (!(mask & (1u << d)));
+            exits[room] = static_cast<std::uint8_t>(d);
+            room = rooms.neighbour(room, d);
+        }
+        for (room = first; !inTree[room]; room = rooms.neighbour(room, exits[room])) {
+            inTree[room] = true;
+            rooms.carve(room, exits[room]);
+        }
+    }
+}
+
+// Knock out walls between rooms to turn a perfect maze into one with loops
+void addLoops(RoomLayout& rooms, double density, Random& random) {
+    if (density <= 0.0) {
+        return;
+    }
+    for (int room = 0; room < rooms.count(); ++room) {
+        unsigned mask = rooms.neighbourMask(room);
+        for (int d = 1; d < 4; d += 2) {
+            if ((mask & (1u << d)) && rooms.walled(room, d) && random.chance(density)) {
+                rooms.carve(room, d);
+            }
+        }
+    }
+}
+
+// Eller's algorithm: a perfect maze one row of rooms at a time, keeping
+// only which set (rooms joined so far) each room of the current row is in,
+// so memory is O(width) however tall the maze. Rooms are joined to the
+// right at random when in different sets, and every set continues down
+// at least once; the last row joins whatever is still apart. Loops open
+// walls of the finished rows only, with the density addLoops() uses.
+class EllerRows {
+public:
+    EllerRows(int width, int height, double loopDensity, Random& random)
+        : width_(width), cols_((width - 1) / 2), roomRows_((height - 1) / 2), y_(0), loopDensity_(loopDensity),
+          random_(random), sets_(cols_, -1), parent_(cols_), lastMember_(cols_), used_(cols_), right_(cols_),
+          down_(cols_) {}
+
+    /// Wall bits of the next row, top to bottom: (width + 63) / 64 words
+    void nextRow(std::uint64_t* words) {
+        int wordsPerRow = (width_ + 63) / 64;
+        std::fill(words, words + wordsPerRow, ~std::uint64_t(0));
+        if (width_ & 63) {
+            words[wordsPerRow - 1] = (std::uint64_t(1) << (width_ & 63)) - 1;
+        }
+        int roomRow = (y_ - 1) / 2;
+        if (y_ % 2 == 1 && roomRow < roomRows_) {
+            joinRow(roomRow + 1 == roomRows_);
+            for (int i = 0; i < cols_; ++i) {
+                clear(words, 2 * i + 1);
+                if (right_[i] || (i + 1 < cols_ && loop())) {
+                    clear(words, 2 * i + 2);
+                }
+            }
+        } else if (y_ > 0 && y_ % 2 == 0 && roomRow + 1 < roomRows_) {
+            for (int i = 0; i < cols_; ++i) {
+                if (down_[i] || loop()) {
+                    clear(words, 2 * i + 1);
+                }
+            }
+        }
+        ++y_;
+    }
+
+private:
+    static void clear(std::uint64_t* words, int x) { words[x >> 6] &= ~(std::uint64_t(1) << (x & 63)); }
+
+    /// Whether to open a wall the perfect maze keeps; the sets never learn
+    /// of it, so each one adds a loop as addLoops() does
+    bool loop() { return loopDensity_ > 0.0 && random_.chance(loopDensity_); }
+
+    int find(int set) {
+        while (parent_[set] != set) {
+            parent_[set] = parent_[parent_[set]];
+            set = parent_[set];
+        }
+        return set;
+    }
+
+    void joinRow(bool last) {
+        // Rooms not joined from above start sets of their own; fewer than
+        // cols_ sets are ever live, so labels below cols_ suffice
+        std::fill(used_.begin(), used_.end(), false);
+        for (int i = 0; i < cols_; ++i) {
+            if (sets_[i] >= 0) {
+                used_[sets_[i]] = true;
+            }
+        }
+        int label = 0;
+        for (int i = 0; i < cols_; ++i) {
+            if (sets_[i] < 0) {
+                while (used_[label]) {
+                    ++label;
+                }
+                sets_[i] = label;
+                used_[label] = true;
+            }
+        }
+
+        std::iota(parent_.begin(), parent_.end(), 0);
+        for (int i = 0; i + 1 < cols_; ++i) {
+            int a = find(sets_[i]);
+            int b = find(sets_[i + 1]);
+            if (a != b) {
+                right_[i] = last || random_.chance(0.5);
+                if (right_[i]) {
+                    parent_[b] = a;
+                }
+            } else {
+                right_[i] = false;
+            }
+        }
+        if (cols_ > 0) {
+            right_[cols_ - 1] = false;
+        }
+        for (int i = 0; i < cols_; ++i) {
+            sets_[i] = find(sets_[i]);
+        }
+        if (last) {
+            return;
+        }
+
+        // Random rooms go down, then the last room of each set that has
+        // none so far
+        std::fill(used_.begin(), used_.end(), false);
+        for (int i = 0; i < cols_; ++i) {
+            down_[i] = random_.chance(0.5);
+            if (down_[i]) {
+                used_[sets_[i]] = true;
+            }
+            lastMember_[sets_[i]] = i;
+        }
+        for (int i = 0; i < cols_; ++i) {
+            if (!used_[sets_[i]] && lastMember_[sets_[i]] == i) {
+                down_[i] = true;
+            }
+        }
+        for (int i = 0; i < cols_; ++i) {
+            if (!down_[i]) {
+                sets_[i] = -1;
+            }
+        }
+    }
+
+    int width_;
+    int cols_;
+    int roomRows_;
+    int y_;
+    double loopDensity_;
+    Random& random_;
+    std::vector<int> sets_;         ///< Set of each room in the current row, -1 for none yet
+    std::vector<int> parent_;       ///< Union-find over the set labels of one row
+    std::vector<int> lastMember_;
+    std::vector<bool> used_;
+    std::vector<bool> right_;       ///< Room i is open to room i + 1
+    std::vector<bool> down_;        ///< Room i is open to the room below
+};
+
+// Noise smoothed by the 4-5 rule: a cell becomes wall when at least 5 of
+// the 9 cells around it (itself included, outside counting as wall) are
+void smoothCave(const WallBitmap& walls, WallBitmap& next) {
+    int width = walls.width();
+    int height = walls.height();
+    parallelForRanges(height, kRowsPerChunk, [&](int first, int last) {
+        // Walls per column over the rows y-1..y+1
+        std::vector<std::uint8_t> columns(width + 2, 3);
+        for (int y = first; y < last; ++y) {
+            for (int x = 0; x < width; ++x) {
+                columns[x + 1] = static_cast<std::uint8_t>((y == 0 || walls.isWall(x, y - 1)) + walls.isWall(x, y) +
+                                                           (y + 1 == height || walls.isWall(x, y + 1)));
+            }
+            std::uint64_t* row = next.row(y);
+            std::fill(row, row + next.wordsPerRow(), 0);
+            for (int x = 0; x < width; ++x) {
+                bool border = x == 0 || y == 0 || x + 1 == width || y + 1 == height;
+                if (border || columns[x] + columns[x + 1] + columns[x + 2] >= 5) {
+                    row[x >> 6] |= std::uint64_t(1) << (x & 63);
+                }
+            }
+        }
+    });
+}
+
+WallBitmap generateCave(const GeneratorOptions& options, Random& random, Coordinates& start, Coordinates& end) {
+    int width = options.width;
+    int height = options.height;
+    WallBitmap walls(width, height);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            if (x == 0 || y == 0 || x + 1 == width || y + 1 == height || random.chance(options.wallDensity)) {
+                walls.setWall(x, y);
+            }
+        }
+    }
+    WallBitmap next(width, height);
+    for (int round = 0; round < kCaveRounds; ++round) {
+        smoothCave(walls, next);
+        std::swap(walls, next);
+    }
+
+    // Caverns need not touch, so a winding corridor always joins the corners
+    start = Coordinates(1, 1);
+    end = Coordinates(width - 2, height - 2);
+    int x = start.first;
+    int y = start.second;
+    walls.clearWall(x, y);
+    while (x != end.first || y != end.second) {
+        int dx = end.first - x;
+        int dy = end.second - y;
+        if (dy == 0 || (dx > 0 && random.chance(static_cast<double>(dx) / (dx + dy)))) {
+            ++x;
+        } else {
+            ++y;
+        }
+        walls.clearWall(x, y);
+    }
+    return walls;
+}
+
+// Top-left room to bottom-right room
+void roomEndpoints(const GeneratorOptions& options, Coordinates& start, Coordinates& end) {
+    start = Coordinates(1, 1);
+    end = Coordinates(2 * ((options.width - 1) / 2) - 1, 2 * ((options.height - 1) / 2) - 1);
+}
+
+// Room styles share the layout; every room is open from the start and
+// only the walls between rooms are carved
+WallBitmap generateRooms(const GeneratorOptions& options, Random& random, Coordinates& start, Coordinates& end) {
+    WallBitmap walls(options.width, options.height);
+    std::uint64_t lastWordMask = (options.width & 63) ? (std::uint64_t(1) << (options.width & 63)) - 1
+                                                     : ~std::uint64_t(0);
+    for (int y = 0; y < options.height; ++y) {
+        std::uint64_t* row = walls.row(y);
+        std::fill(row, row + walls.wordsPerRow(), ~std::uint64_t(0));
+        row[walls.wordsPerRow() - 1] &= lastWordMask;
+    }
+    RoomLayout rooms(walls);
+    for (int y = 0; y < rooms.rows(); ++y) {
+        for (int x = 0; x < rooms.cols(); ++x) {
+            walls.clearWall(2 * x + 1, 2 * y + 1);
+        }
+    }
+
+    switch (options.style) {
+        case STYLE_KRUSKAL: carveKruskal(rooms, random); break;
+        case STYLE_PRIM: carvePrim(rooms, random); break;
+        case STYLE_WILSON: carveWilson(rooms, random); break;
+        default: carveBacktracker(rooms, random); break;
+    }
+    addLoops(rooms, options.loopDensity, random);
+
+    roomEndpoints(options, start, end);
+    return walls;
+}
+
+} // namespace
+
+bool parseMazeStyle(const std::string& name, MazeStyle& style) {
+    for (int i = 0; i <= STYLE_ELLER; ++i) {
+        if (name == kStyleNames[i]) {
+            style = static_cast<MazeStyle>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* mazeStyleName(MazeStyle style) {
+    return kStyleNames[style];
+}
+
+bool parseGeneratorSpec(const std::string& spec, GeneratorOptions& options) {
+    std::size_t colon = spec.find(':');
+    if (colon == std::string::npos || !parseMazeStyle(spec.substr(0, colon), options.style)) {
+        return false;
+    }
+    std::string rest = spec.substr(colon + 1);
+    std::size_t seedColon = rest.find(':');
+    char trailing;
+    if (std::sscanf(rest.substr(0, seedColon).c_str(), "%dx%d%c", &options.width, &options.height, &trailing) != 2) {
+        return false;
+    }
+    if (seedColon != std::string::npos) {
+        char* parsed = nullptr;
+        std::string seed = rest.substr(seedColon + 1);
+        options.seed = std::strtoull(seed.c_str(), &parsed, 10);
+        return !seed.empty() && *parsed == '\0';
+    }
+    return true;
+}
+
+WallBitmap generateMaze(const GeneratorOptions& options, Coordinates& start, Coordinates& end) {
+    if (options.width < 3 || options.height < 3 || !Grid::fits(options.width, options.height)) {
+        std::cerr << "Error: Cannot generate a " << options.width << "x" << options.height << " maze" << std::endl;
+        return WallBitmap();
+    }
+    Random random(options.seed);
+    if (options.style == STYLE_ELLER) {
+        WallBitmap walls(options.width, options.height);
+        EllerRows rows(options.width, options.height, options.loopDensity, random);
+        for (int y = 0; y < options.height; ++y) {
+            rows.nextRow(walls.row(y));
+        }
+        roomEndpoints(options, start, end);
+        return walls;
+    }
+    return options.style == STYLE_CAVE ? generateCave(options, random, start, end)
+                                       : generateRooms(options, random, start, end);
+}
+
+Grid generateGrid(const GeneratorOptions& options, Coordinates& start, Coordinates& end) {
+    WallBitmap walls = generateMaze(options, start, end);
+    if (walls.width() == 0) {
+        return Grid();
+    }
+    Grid maze(walls.width(), walls.height());
+    parallelForRanges(walls.height(), kRowsPerChunk, [&](int first, int last) {
+        maze.setWalls(walls, first, last);
+    });
+    maze.at(start.first, start.second) = CELL_START;
+    maze.at(end.first, end.second) = CELL_END;
+    parallelForRanges(walls.height(), kRowsPerChunk, [&](int first, int last) {
+        maze.computeNeighbourMasks(first, last);
+    });
+    return maze;
+}
+
+bool generateTiledMaze(const std::string& filename, const GeneratorOptions& options, int tileSize) {
+    if (options.style != STYLE_ELLER) {
+        Coordinates start, end;
+        WallBitmap walls = generateMaze(options, start, end);
+        return walls.width() > 0 && writeTiledMaze(filename, walls, tileSize, LargeCoordinates(start.first, start.second),
+                                                   LargeCoordinates(end.first, end.second));
+    }
+    if (options.width < 3 || options.height < 3) {
+        std::cerr << "Error: Cannot generate a " << options.width << "x" << options.height << " maze" << std::endl;
+        return false;
+    }
+
+    Coordinates start, end;
+    roomEndpoints(options, start, end);
+    TiledMazeWriter writer;
+    if (!writer.open(filename, options.width, options.height, tileSize, LargeCoordinates(start.first, start.second),
+                     LargeCoordinates(end.first, end.second))) {
+        return false;
+    }
+    Random random(options.seed);
+    EllerRows rows(options.width, options.height, options.loopDensity, random);
+    std::vector<std::uint64_t> row((options.width + 63) / 64);
+    for (int y = 0; y < options.height; ++y) {
+        rows.nextRow(row.data());
+        if (!writer.writeRow(row.data())) {
+            break;
+        }
+    }
+    return writer.close();
+}
@@ -1,104 +1,221 @@
-#include "../include/types.h"
-#include <fstream>
+#include "../include/maze_loader.h"
+#include "../include/binary_maze.h"
+#include "../include/mapped_file.h"
+#include "../include/parallel.h"
+#include "../include/wall_bitmap.h"
+#include <cstdio>
 #include <sstream>
 #include <iostream>
 #include <utility>
 #include <string>
+#include <cstring>
+#include <algorithm>
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
 
-Matrix readMaze(const std::string& filename, Coordinates& start, Coordinates& end) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
+namespace {
+
+// Location of one maze row inside the mapped file
+struct MazeRow {
+    std::size_t offset;
+    int length;
+};
+
+// Rows handed to each loader thread at minimum
+const int kRowsPerChunk = 256;
+
+// Set the wall bit for every 'X' in the line; any other character is path.
+void classifyRow(const char* line, int length, std::uint64_t* words) {
+    int x = 0;
+#if defined(__AVX2__)
+    const __m256i wall32 = _mm256_set1_epi8('X');
+    for (; x + 32 <= length; x += 32) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(line + x));
+        std::uint64_t mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, wall32)));
+        words[x >> 6] |= mask << (x & 63);
+    }
+#endif
+#if defined(__SSE2__)
+    const __m128i wall16 = _mm_set1_epi8('X');
+    for (; x + 16 <= length; x += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(line + x));
+        std::uint64_t mask = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, wall16)));
+        words[x >> 6] |= mask << (x & 63);
+    }
+#endif
+    for (; x < length; ++x) {
+        if (line[x] == 'X') {
+            words[x >> 6] |= std::uint64_t(1) << (x & 63);
+        }
+    }
+}
+
+bool startsWith(const char* line, std::size_t length, const char* prefix) {
+    std::size_t prefixLength = std::strlen(prefix);
+    return length >= prefixLength && std::memcmp(line, prefix, prefixLength) == 0;
+}
+
+} // namespace
+
+Grid readMaze(const std::string& filename, Coordinates& start, Coordinates& end) {
+    MappedFile file;
+    if (!file.open(filename)) {
         std::cerr << "Error: Could not open file " << filename << std::endl;
-        return Matrix();
-    }
-    
-    std::vector<std::string> lines;
-    std::string line;
-    
-    // Read all lines from the file
-    while (std::getline(file, line)) {
-        lines.push_back(line);
-    }
-    
-    file.close();
-    
-    if (lines.size() < 3) {
-        std::cerr << "Error: Invalid maze file format in " << filename << std::endl;
-        return Matrix();
+        return Grid();
+    }
+
+    const char* data = file.data();
+    std::size_t size = file.size();
+
+    // Binary mazes are used straight from the mapping, no parsing needed
+    if (isBinaryMaze(data, size)) {
+        return parseBinaryMaze(data, size, filename, start, end);
     }
-    
-    // Find the maze lines (everything before "start" and "end" lines)
-    std::vector<std::string> mazeLines;
+
+    // One pass over the mapping: record where each maze row starts and pick
+    // out the "start" and "end" lines
+    std::vector<MazeRow> rows;
     std::string startLine, endLine;
-    
-    for (const std::string& l : lines) {
-        if (l.substr(0, 5) == "start") {
-            startLine = l;
-        } else if (l.substr(0, 3) == "end") {
-            endLine = l;
+    std::size_t lineCount = 0;
+    std::size_t widest = 0;
+
+    for (std::size_t pos = 0; pos < size; ++lineCount) {
+        const char* newline = static_cast<const char*>(std::memchr(data + pos, '\n', size - pos));
+        std::size_t lineEnd = newline ? static_cast<std::size_t>(newline - data) : size;
+        std::size_t length = lineEnd - pos;
+        if (length > 0 && data[pos + length - 1] == '\r') {
+            --length;
+        }
+
+        if (startsWith(data + pos, length, "start")) {
+            startLine.assign(data + pos, length);
+        } else if (startsWith(data + pos, length, "end")) {
+            endLine.assign(data + pos, length);
         } else {
-            mazeLines.push_back(l);
+            // Lengths past int are rejected with the dimensions below
+            MazeRow row = {pos, static_cast<int>(std::min<std::size_t>(length, INT_MAX))};
+            rows.push_back(row);
+            widest = std::max(widest, length);
         }
+        pos = lineEnd + 1;
     }
-    
-    if (mazeLines.empty() || startLine.empty() || endLine.empty()) {
+
+    if (lineCount < 3) {
         std::cerr << "Error: Invalid maze file format in " << filename << std::endl;
-        return Matrix();
+        return Grid();
     }
-    
-    // Parse dimensions
-    int height = mazeLines.size();
-    int width = 0;
-    for (const std::string& l : mazeLines) {
-        width = std::max(width, static_cast<int>(l.length()));
+
+    if (rows.empty() || startLine.empty() || endLine.empty()) {
+        std::cerr << "Error: Invalid maze file format in " << filename << std::endl;
+        return Grid();
     }
-    
-    if (width <= 0 || height <= 0) {
+
+    // Parse dimensions
+    if (widest > INT_MAX || !Grid::fits(static_cast<long long>(widest), static_cast<long long>(rows.size()))) {
         std::cerr << "Error: Invalid maze dimensions in " << filename << std::endl;
-        return Matrix();
-    }
-    
-    // Initialize maze matrix
-    Matrix maze(height, std::vector<int>(width, 0));
-    
-    // Parse maze data
-    for (int y = 0; y < height; ++y) {
-        const std::string& mazeLine = mazeLines[y];
-        for (int x = 0; x < static_cast<int>(mazeLine.length()) && x < width; ++x) {
-            if (mazeLine[x] == 'X') {
-                maze[y][x] = 1;  // Wall
-            } else if (mazeLine[x] == ' ') {
-                maze[y][x] = 0;  // Path
-            }
-            // Default is 0 (path) for any other character
-        }
+        return Grid();
     }
-    
+    int width = static_cast<int>(widest);
+    int height = static_cast<int>(rows.size());
+
     // Parse start coordinates
-    std::istringstream startStream(startLine.substr(6)); // Skip "start "
+    std::istringstream startStream(startLine.substr(5)); // Skip "start"
     char comma;
     if (!(startStream >> start.first >> comma >> start.second)) {
         std::cerr << "Error: Invalid start coordinates in " << filename << std::endl;
-        return Matrix();
+        return Grid();
     }
-    
+
     // Parse end coordinates
-    std::istringstream endStream(endLine.substr(4)); // Skip "end "
+    std::istringstream endStream(endLine.substr(3)); // Skip "end"
     if (!(endStream >> end.first >> comma >> end.second)) {
         std::cerr << "Error: Invalid end coordinates in " << filename << std::endl;
-        return Matrix();
+        return Grid();
     }
-    
-    // Validate coordinates
+
+    // Validate coordinates before any cell storage is allocated
     if (start.first < 0 || start.first >= width || start.second < 0 || start.second >= height ||
         end.first < 0 || end.first >= width || end.second < 0 || end.second >= height) {
         std::cerr << "Error: Invalid coordinates in " << filename << std::endl;
-        return Matrix();
+        return Grid();
     }
-    
+
+    // Classify row chunks in parallel straight from the mapping
+    WallBitmap walls(width, height);
+    parallelForRanges(height, kRowsPerChunk, [&](int first, int last) {
+        for (int y = first; y < last; ++y) {
+            classifyRow(data + rows[y].offset, rows[y].length, walls.row(y));
+        }
+    });
+
+    // Initialize maze grid (all cells start as path) and copy the walls in
+    Grid maze(width, height);
+    parallelForRanges(height, kRowsPerChunk, [&](int first, int last) {
+        maze.setWalls(walls, first, last);
+    });
+
     // Mark start and end positions in the maze
-    maze[start.second][start.first] = -1;
-    maze[end.second][end.first] = -2;
-    
+    maze.at(start.first, start.second) = CELL_START;
+    maze.at(end.first, end.second) = CELL_END;
+    parallelForRanges(height, kRowsPerChunk, [&](int first, int last) {
+        maze.computeNeighbourMasks(first, last);
+    });
+
     return maze;
-} 
\ No newline at end of file
+}
+
+bool writeTextMaze(const std::string& filename, const WallBitmap& walls,
+                   const Coordinates& start, const Coordinates& end) {
+    std::FILE* file = std::fopen(filename.c_str(), "w");
+    if (file == nullptr) {
+        std::cerr << "Error: Could not open file " << filename << " for writing" << std::endl;
+        return false;
+    }
+
+    std::string line(walls.width() + 1, '\n');
+    bool ok = true;
+    for (int y = 0; y < walls.height() && ok; ++y) {
+        for (int x = 0; x < walls.width(); ++x) {
+            line[x] = walls.isWall(x, y) ? 'X' : ' ';
+        }
+        ok = std::fwrite(line.data(), 1, line.size(), file) == line.size();
+    }
+    ok = ok && std::fprintf(file, "start %d, %d\nend %d, %d\n", start.first, start.second, end.first, end.second) > 0;
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok) {
+        std::cerr << "Error: Could not write " << filename << std::endl;
+    }
+    return ok;
+}
+
+bool writeSolvedMaze(const std::string& filename, const Grid& maze, const std::vector<Coordinates>& path,
+                     const Coordinates& start, const Coordinates& end) {
+    std::FILE* file = std::fopen(filename.c_str(), "w");
+    if (file == nullptr) {
+        std::cerr << "Error: Could not open file " << filename << " for writing" << std::endl;
+        return false;
+    }
+
+    // Row-major copy of the maze as text, with the path drawn over it
+    std::size_t stride = static_cast<std::size_t>(maze.width()) + 1;
+    std::string text(stride * maze.height(), '\n');
+    for (int y = 0; y < maze.height(); ++y) {
+        for (int x = 0; x < maze.width(); ++x) {
+            text[y * stride + x] = maze.at(x, y) == CELL_WALL ? 'X' : ' ';
+        }
+    }
+    for (const Coordinates& p : path) {
+        text[p.second * stride + p.first] = '*';
+    }
+    text[start.second * stride + start.first] = 'S';
+    text[end.second * stride + end.first] = 'E';
+
+    bool ok = std::fwrite(text.data(), 1, text.size(), file) == text.size();
+    ok = ok && std::fprintf(file, "start %d, %d\nend %d, %d\n", start.first, start.second, end.first, end.second) > 0;
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok) {
+        std::cerr << "Error: Could not write " << filename << std::endl;
+    }
+    return ok;
+}
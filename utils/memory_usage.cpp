@@ -0,0 +1,18 @@
+#include "../include/memory_usage.h"
+#include <cstdio>
+
+std::string formatBytes(std::size_t bytes) {
+    static const char* const units[] = {"B", "KB", "MB", "GB", "TB"};
+    if (bytes < 1024) {
+        return std::to_string(bytes) + " B";
+    }
+    double value = static_cast<double>(bytes);
+    int unit = 0;
+    while (value >= 1024 && unit < 4) {
+        value /= 1024;
+        ++unit;
+    }
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.1f %s", value, units[unit]);
+    return text;
+}
@@ -0,0 +1,117 @@
+#include "../include/parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+std::atomic<int> workerOverride(0);
+thread_local int threadWorkerLimit = 0;    ///< 0 when the thread has no cap of its own
+
+} // namespace
+
+int workerCount() {
+    if (threadWorkerLimit > 0) {
+        return threadWorkerLimit;
+    }
+    int count = workerOverride.load(std::memory_order_relaxed);
+    if (count > 0) {
+        return count;
+    }
+    unsigned hardware = std::thread::hardware_concurrency();
+    return hardware == 0 ? 1 : static_cast<int>(hardware);
+}
+
+void setWorkerCount(int count) {
+    workerOverride.store(std::max(count, 0), std::memory_order_relaxed);
+}
+
+ThreadWorkerLimit::ThreadWorkerLimit(int count) : previous_(threadWorkerLimit) {
+    if (count > 0) {
+        threadWorkerLimit = count;
+    }
+}
+
+ThreadWorkerLimit::~ThreadWorkerLimit() {
+    threadWorkerLimit = previous_;
+}
+
+void parallelForRanges(int count, int minChunk, const std::function<void(int, int)>& fn) {
+    if (count <= 0) {
+        return;
+    }
+    int maxRanges = (count + std::max(minChunk, 1) - 1) / std::max(minChunk, 1);
+    int ranges = std::min(workerCount(), maxRanges);
+    if (ranges <= 1) {
+        fn(0, count);
+        return;
+    }
+
+    std::vector<std::thread> threads;
+    threads.reserve(ranges - 1);
+    int perRange = (count + ranges - 1) / ranges;
+    for (int first = perRange; first < count; first += perRange) {
+        threads.push_back(std::thread(fn, first, std::min(first + perRange, count)));
+    }
+    fn(0, std::min(perRange, count));
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+WorkerTeam::WorkerTeam(int threads) : task_(nullptr), generation_(0), pending_(0), stopping_(false) {
+    for (int thread = 1; thread < threads; ++thread) {
+        threads_.push_back(std::thread(&WorkerTeam::work, this, thread));
+    }
+}
+
+WorkerTeam::~WorkerTeam() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread& thread : threads_) {
+        thread.join();
+    }
+}
+
+void WorkerTeam::run(const std::function<void(int)>& fn) {
+    if (threads_.empty()) {
+        fn(0);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        task_ = &fn;
+        pending_ = static_cast<int>(threads_.size());
+        ++generation_;
+    }
+    wake_.notify_all();
+    fn(0);
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this] { return pending_ == 0; });
+    task_ = nullptr;
+}
+
+void WorkerTeam::work(int thread) {
+    unsigned long seen = 0;
+    for (;;) {
+        const std::function<void(int)>* task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this, seen] { return stopping_ || generation_ != seen; });
+            if (stopping_) {
+                return;
+            }
+            seen = generation_;
+            task = task_;
+        }
+        (*task)(thread);
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--pending_ == 0) {
+            done_.notify_one();
+        }
+    }
+}
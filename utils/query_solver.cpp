@@ -0,0 +1,115 @@
+#include "../include/query_solver.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+// Queries a thread takes from the shared counter at a time
+const std::size_t kQueryChunk = 8;
+
+// Queries an end needs before its distance field is built: a field costs
+// about one BFS over the maze, more than a few A* searches
+const int kFieldQueries = 4;
+
+bool openCell(const Grid& maze, const Coordinates& c) {
+    return c.first >= 0 && c.first < maze.width() && c.second >= 0 && c.second < maze.height() &&
+           maze.at(c.first, c.second) != CELL_WALL;
+}
+
+} // namespace
+
+QuerySolver::QuerySolver(const Grid& maze, const AlgorithmInfo& algorithm, int threads)
+    : maze_(maze), algorithm_(algorithm), fields_(nullptr), team_(std::max(threads, 1)), paths_(team_.size()) {
+    for (int thread = 0; thread < team_.size(); ++thread) {
+        workspaces_.push_back(std::unique_ptr<SearchWorkspace>(new SearchWorkspace()));
+    }
+}
+
+void QuerySolver::useDistanceFields(DistanceFieldCache* cache, const std::string& mazeKey) {
+    fields_ = cache;
+    mazeKey_ = mazeKey;
+}
+
+QueryBatchStats QuerySolver::solve(const std::vector<PathQuery>& queries, std::vector<QueryResult>& results,
+                                   bool keepPaths) {
+    results.resize(queries.size());
+    std::atomic<std::size_t> nextQuery(0);
+    Clock::time_point batchStart = Clock::now();
+
+    // Fields of the shared ends, built before the team starts so no two
+    // threads flood the same end
+    std::map<int, std::shared_ptr<const DistanceField>> fields;
+    if (fields_ != nullptr && algorithm_.shortestPaths) {
+        std::map<int, int> queriesPerEnd;
+        for (const PathQuery& query : queries) {
+            if (openCell(maze_, query.end)) {
+                ++queriesPerEnd[maze_.index(query.end)];
+            }
+        }
+        for (const std::pair<const int, int>& end : queriesPerEnd) {
+            if (end.second >= kFieldQueries) {
+                fields[end.first] = fields_->field(mazeKey_, maze_, end.first);
+            }
+        }
+    }
+
+    team_.run([&](int thread) {
+        // The team already runs one query per core; parallel engines stay
+        // on their calling thread
+        ThreadWorkerLimit limit(team_.size() > 1 ? 1 : 0);
+        NullSearchObserver observer;
+        SearchWorkspace& workspace = *workspaces_[thread];
+        for (std::size_t first = nextQuery.fetch_add(kQueryChunk); first < queries.size();
+             first = nextQuery.fetch_add(kQueryChunk)) {
+            std::size_t last = std::min(first + kQueryChunk, queries.size());
+            for (std::size_t i = first; i < last; ++i) {
+                const PathQuery& query = queries[i];
+                QueryResult& result = results[i];
+                std::vector<Coordinates>& path = keepPaths ? result.path : paths_[thread];
+                path.clear();
+                result.path.clear();
+                result.openedNodes = 0;
+                Clock::time_point solveStart = Clock::now();
+                bool valid = openCell(maze_, query.start) && openCell(maze_, query.end);
+                std::map<int, std::shared_ptr<const DistanceField>>::const_iterator field =
+                    valid ? fields.find(maze_.index(query.end)) : fields.end();
+                result.fromField = field != fields.end();
+                if (result.fromField) {
+                    result.found = field->second->path(maze_, maze_.index(query.start), path);
+                } else {
+                    result.found = valid && algorithm_.run(maze_, query.start, query.end, path, result.openedNodes,
+                                                           workspace, observer);
+                }
+                result.solveMs = std::chrono::duration<double, std::milli>(Clock::now() - solveStart).count();
+                result.pathLength = result.found ? path.size() : 0;
+            }
+        }
+    });
+
+    QueryBatchStats stats;
+    stats.queries = queries.size();
+    stats.found = 0;
+    stats.fieldQueries = 0;
+    stats.threads = team_.size();
+    stats.elapsedMs = std::chrono::duration<double, std::milli>(Clock::now() - batchStart).count();
+    stats.solveMs = 0.0;
+    for (const QueryResult& result : results) {
+        stats.found += result.found ? 1 : 0;
+        stats.fieldQueries += result.fromField ? 1 : 0;
+        stats.solveMs += result.solveMs;
+    }
+    stats.queriesPerSecond = stats.elapsedMs > 0 ? stats.queries * 1000.0 / stats.elapsedMs : 0.0;
+    return stats;
+}
+
+std::size_t QuerySolver::memoryBytes() const {
+    std::size_t bytes = 0;
+    for (const std::unique_ptr<SearchWorkspace>& workspace : workspaces_) {
+        bytes += workspace->memoryBytes();
+    }
+    return bytes;
+}
@@ -0,0 +1,41 @@
+#include "../include/resource_usage.h"
+#include <cstdio>
+#include <cstring>
+#include <sys/resource.h>
+
+bool resetPeakRss() {
+    std::FILE* file = std::fopen("/proc/self/clear_refs", "w");
+    if (file == nullptr) {
+        return false;
+    }
+    // "5" resets the VmHWM peak to the current RSS
+    bool ok = std::fputs("5", file) >= 0;
+    ok = std::fclose(file) == 0 && ok;
+    return ok;
+}
+
+long peakRssKb() {
+    std::FILE* file = std::fopen("/proc/self/status", "r");
+    if (file != nullptr) {
+        char line[256];
+        long value = -1;
+        while (std::fgets(line, sizeof(line), file) != nullptr) {
+            if (std::strncmp(line, "VmHWM:", 6) == 0) {
+                std::sscanf(line + 6, "%ld", &value);
+                break;
+            }
+        }
+        std::fclose(file);
+        if (value >= 0) {
+            return value;
+        }
+    }
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+    return usage.ru_maxrss / 1024;  // Bytes on macOS
+#else
+    return usage.ru_maxrss;
+#endif
+}
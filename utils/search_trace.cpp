@@ -0,0 +1,204 @@
+#include "../include/search_trace.h"
+#include "../include/binary_maze.h"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+void putVarint(std::vector<unsigned char>& out, std::int64_t delta) {
+    std::uint64_t value = (static_cast<std::uint64_t>(delta) << 1) ^ static_cast<std::uint64_t>(delta >> 63);
+    while (value >= 0x80) {
+        out.push_back(static_cast<unsigned char>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<unsigned char>(value));
+}
+
+// Varints from a byte range; fails on running out or on overlong input
+class VarintReader {
+public:
+    VarintReader(const unsigned char* data, std::size_t size) : data_(data), end_(data + size) {}
+
+    bool next(std::int64_t& delta) {
+        std::uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (data_ == end_) {
+                return false;
+            }
+            unsigned char byte = *data_++;
+            value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) {
+                delta = static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    const unsigned char* data_;
+    const unsigned char* end_;
+};
+
+// Decode count cells into cells, continuing the delta chain from previous
+bool readCells(VarintReader& reader, std::size_t count, std::int64_t cellCount, std::int64_t& previous,
+               std::vector<int>& cells) {
+    cells.resize(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        std::int64_t delta;
+        if (!reader.next(delta)) {
+            return false;
+        }
+        previous += delta;
+        if (previous < 0 || previous >= cellCount) {
+            return false;
+        }
+        cells[i] = static_cast<int>(previous);
+    }
+    return true;
+}
+
+} // namespace
+
+bool TraceRecorder::onExpand(const Grid& /* maze */, int cell, int /* openedNodes */) {
+    trace_.expanded.push_back(cell);
+    return true;
+}
+
+void TraceRecorder::onPathFound(const Grid& maze, const std::vector<Coordinates>& path) {
+    trace_.path.clear();
+    trace_.path.reserve(path.size());
+    for (const Coordinates& p : path) {
+        trace_.path.push_back(maze.index(p));
+    }
+}
+
+SearchTrace recordSearch(const AlgorithmInfo& algorithm, const Grid& maze, const std::string& mazeFile,
+                         const Coordinates& start, const Coordinates& end, SearchWorkspace& workspace) {
+    SearchTrace trace;
+    trace.algorithm = algorithm.key;
+    trace.mazeFile = mazeFile;
+    trace.width = maze.width();
+    trace.height = maze.height();
+    trace.start = start;
+    trace.end = end;
+    trace.contentHash = hashWalls(maze.walls());
+
+    TraceRecorder recorder(trace);
+    std::vector<Coordinates> path;
+    int openedNodes = 0;
+    trace.found = algorithm.run(maze, start, end, path, openedNodes, workspace, recorder);
+    if (!trace.found) {
+        trace.path.clear();
+    }
+    return trace;
+}
+
+bool traceMatches(const SearchTrace& trace, const Grid& maze) {
+    return maze.width() == trace.width && maze.height() == trace.height && hashWalls(maze.walls()) == trace.contentHash;
+}
+
+bool writeTrace(const std::string& filename, const SearchTrace& trace) {
+    if (trace.algorithm.size() > 0xffff || trace.mazeFile.size() > 0xffff) {
+        std::cerr << "Error: Names too long for trace " << filename << std::endl;
+        return false;
+    }
+    TraceHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kTraceMagic, sizeof(kTraceMagic));
+    header.version = kTraceVersion;
+    header.width = static_cast<std::uint32_t>(trace.width);
+    header.height = static_cast<std::uint32_t>(trace.height);
+    header.startX = trace.start.first;
+    header.startY = trace.start.second;
+    header.endX = trace.end.first;
+    header.endY = trace.end.second;
+    header.contentHash = trace.contentHash;
+    header.expandedCount = trace.expanded.size();
+    header.pathCount = static_cast<std::uint32_t>(trace.path.size());
+    header.algorithmBytes = static_cast<std::uint16_t>(trace.algorithm.size());
+    header.mazeFileBytes = static_cast<std::uint16_t>(trace.mazeFile.size());
+    header.found = trace.found ? 1 : 0;
+
+    // One chain of deltas through the opened cells and on into the path
+    std::vector<unsigned char> cells;
+    cells.reserve(trace.expanded.size() * 2 + trace.path.size());
+    std::int64_t previous = 0;
+    for (int cell : trace.expanded) {
+        putVarint(cells, cell - previous);
+        previous = cell;
+    }
+    for (int cell : trace.path) {
+        putVarint(cells, cell - previous);
+        previous = cell;
+    }
+
+    std::FILE* file = std::fopen(filename.c_str(), "wb");
+    if (file == nullptr) {
+        std::cerr << "Error: Could not open file " << filename << " for writing" << std::endl;
+        return false;
+    }
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+              std::fwrite(trace.algorithm.data(), 1, trace.algorithm.size(), file) == trace.algorithm.size() &&
+              std::fwrite(trace.mazeFile.data(), 1, trace.mazeFile.size(), file) == trace.mazeFile.size() &&
+              std::fwrite(cells.data(), 1, cells.size(), file) == cells.size();
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok) {
+        std::cerr << "Error: Could not write " << filename << std::endl;
+    }
+    return ok;
+}
+
+bool readTrace(const std::string& filename, SearchTrace& trace) {
+    std::FILE* file = std::fopen(filename.c_str(), "rb");
+    if (file == nullptr) {
+        std::cerr << "Error: Could not open file " << filename << std::endl;
+        return false;
+    }
+    std::vector<unsigned char> data;
+    unsigned char buffer[1 << 16];
+    std::size_t got;
+    while ((got = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        data.insert(data.end(), buffer, buffer + got);
+    }
+    std::fclose(file);
+
+    TraceHeader header;
+    if (data.size() < sizeof(header) || std::memcmp(data.data(), kTraceMagic, sizeof(kTraceMagic)) != 0) {
+        std::cerr << "Error: " << filename << " is not a search trace" << std::endl;
+        return false;
+    }
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (header.version != kTraceVersion) {
+        std::cerr << "Error: Unsupported trace version " << header.version << " in " << filename << std::endl;
+        return false;
+    }
+    std::size_t names = sizeof(header) + header.algorithmBytes + header.mazeFileBytes;
+    // Every cell takes at least one byte, which also bounds the counts
+    if (header.width == 0 || header.height == 0 || header.width > 1000000 || header.height > 1000000 ||
+        data.size() < names || data.size() - names < header.expandedCount + header.pathCount) {
+        std::cerr << "Error: Invalid or truncated trace " << filename << std::endl;
+        return false;
+    }
+    const char* text = reinterpret_cast<const char*>(data.data() + sizeof(header));
+    trace.algorithm.assign(text, header.algorithmBytes);
+    trace.mazeFile.assign(text + header.algorithmBytes, header.mazeFileBytes);
+    trace.width = static_cast<int>(header.width);
+    trace.height = static_cast<int>(header.height);
+    trace.start = Coordinates(header.startX, header.startY);
+    trace.end = Coordinates(header.endX, header.endY);
+    trace.contentHash = header.contentHash;
+    trace.found = header.found != 0;
+
+    std::int64_t cellCount = (static_cast<std::int64_t>(trace.width) + 2) * (trace.height + 2);
+    VarintReader reader(data.data() + names, data.size() - names);
+    std::int64_t previous = 0;
+    if (cellCount > 0x7fffffff ||
+        !readCells(reader, static_cast<std::size_t>(header.expandedCount), cellCount, previous, trace.expanded) ||
+        !readCells(reader, header.pathCount, cellCount, previous, trace.path)) {
+        std::cerr << "Error: Corrupt cell data in trace " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
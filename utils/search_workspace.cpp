@@ -0,0 +1,125 @@
+#include "../include/search_workspace.h"
+#include <algorithm>
+
+SearchWorkspace::SearchWorkspace()
+    : stamps_(CountingAllocator<std::uint16_t>(&parentMemory_)), epoch_(0),
+      parents_(CountingAllocator<std::uint8_t>(&parentMemory_)), costs_(CountingAllocator<int>(&parentMemory_)),
+      jumpParents_(CountingAllocator<int>(&parentMemory_)), openList_(TIES_LIFO, &frontierMemory_) {}
+
+SearchWorkspace::~SearchWorkspace() {}
+
+void SearchWorkspace::reset(const Grid& maze, bool withCosts, bool withJumpParents) {
+    startRun();
+    std::size_t cells = static_cast<std::size_t>(maze.cellCount());
+    // Stamps only grow, and stamps of earlier runs never match the new
+    // epoch; they are cleared once each time the 16-bit epoch wraps
+    if (stamps_.size() < cells) {
+        stamps_.resize(cells, 0);
+    }
+    if (++epoch_ == 0) {
+        std::fill(stamps_.begin(), stamps_.end(), 0);
+        epoch_ = 1;
+    }
+    parents_.resize((cells + 3) / 4);
+    if (withCosts) {
+        costs_.resize(cells);
+    }
+    if (withJumpParents) {
+        jumpParents_.resize(cells);
+    }
+    pushes_ = 0;
+}
+
+void SearchWorkspace::reconstructPath(const Grid& maze, int startId, int endId, std::vector<Coordinates>& path) const {
+    path.clear();
+    int id = endId;
+    while (id != startId) {
+        path.push_back(maze.coordinates(id));
+        id -= maze.offset(parentDirection(id));
+    }
+    path.push_back(maze.coordinates(startId));
+    std::reverse(path.begin(), path.end());
+}
+
+void SearchWorkspace::reconstructJumpPath(const Grid& maze, int startId, int endId, std::vector<Coordinates>& path) const {
+    path.clear();
+    int id = endId;
+    while (id != startId) {
+        int from = jumpParents_[id];
+        int step = maze.offset(parentDirection(id));
+        for (int cell = id; cell != from; cell -= step) {
+            path.push_back(maze.coordinates(cell));
+        }
+        id = from;
+    }
+    path.push_back(maze.coordinates(startId));
+    std::reverse(path.begin(), path.end());
+}
+
+void SearchWorkspace::reconstructPath(const Grid& maze, int startId, int forwardId, int backwardId, int endId,
+                                      std::vector<Coordinates>& path) const {
+    reconstructPath(maze, startId, forwardId, path);
+    if (forwardId == endId) {
+        return;
+    }
+    int id = backwardId;
+    if (id == forwardId) {
+        // Already the last cell of the forward half
+        id -= maze.offset(backward_->parentDirection(id));
+    }
+    while (id != endId) {
+        path.push_back(maze.coordinates(id));
+        id -= maze.offset(backward_->parentDirection(id));
+    }
+    path.push_back(maze.coordinates(endId));
+}
+
+// The backward workspace starts over too, so a one-way run after a
+// bidirectional one does not report the older run's allocations
+void SearchWorkspace::startRun() {
+    parentMemory_.startRun();
+    frontierMemory_.startRun();
+    openListUsed_ = false;
+    peakFrontier_ = 0;
+    if (backward_) {
+        backward_->startRun();
+    }
+}
+
+SearchWorkspace& SearchWorkspace::backward() {
+    if (!backward_) {
+        backward_.reset(new SearchWorkspace());
+    }
+    return *backward_;
+}
+
+void SearchWorkspace::memoryUsage(const Grid& maze, const std::vector<Coordinates>& path, RunMemory& memory) const {
+    searchMemory(memory);
+    memory.path = MemoryUsage();
+    memory.path.bytes = memory.path.peakBytes = path.capacity() * sizeof(Coordinates);
+    memory.path.allocations = path.capacity() > 0 ? 1 : 0;
+    memory.maze = maze.memoryUsage();
+}
+
+void SearchWorkspace::searchMemory(RunMemory& memory) const {
+    memory.parents = parentMemory_.usage();
+    memory.frontier = frontierMemory_.usage();
+    memory.peakFrontier = std::max(peakFrontier_, openListUsed_ ? openList_.peakSize() : std::size_t(0));
+    if (backward_) {
+        // Both sides grow at once, so their peaks add up
+        RunMemory backward;
+        backward_->searchMemory(backward);
+        memory.parents += backward.parents;
+        memory.frontier += backward.frontier;
+        memory.peakFrontier += backward.peakFrontier;
+    }
+}
+
+std::size_t SearchWorkspace::memoryBytes() const {
+    return stamps_.capacity() * sizeof(std::uint16_t) +
+           parents_.capacity() * sizeof(std::uint8_t) +
+           costs_.capacity() * sizeof(int) +
+           jumpParents_.capacity() * sizeof(int) +
+           openList_.memoryBytes() +
+           (backward_ ? backward_->memoryBytes() : 0);
+}
@@ -0,0 +1,112 @@
+#include "../include/tile_cache.h"
+#include <algorithm>
+#include <cerrno>
+#include <unistd.h>
+
+TileCache::TileCache()
+    : fd_(-1), offset_(0), blockWords_(0), capacity_(0), lastIndex_(-1), last_(nullptr), ok_(true), loads_(0),
+      evictions_(0), writeBacks_(0) {}
+
+TileCache::~TileCache() {
+    close();
+}
+
+void TileCache::open(int fd, std::uint64_t offset, std::size_t blockWords, std::size_t budgetBytes) {
+    close();
+    fd_ = fd;
+    offset_ = offset;
+    blockWords_ = blockWords;
+    capacity_ = std::max<std::size_t>(1, budgetBytes / (blockWords * sizeof(std::uint64_t)));
+    ok_ = true;
+    loads_ = evictions_ = writeBacks_ = 0;
+}
+
+void TileCache::close() {
+    if (fd_ >= 0) {
+        flush();
+        ::close(fd_);
+    }
+    fd_ = -1;
+    blocks_.clear();
+    index_.clear();
+    lastIndex_ = -1;
+    last_ = nullptr;
+}
+
+TileCache::Block* TileCache::fetch(std::int64_t index) {
+    std::unordered_map<std::int64_t, std::list<Block>::iterator>::iterator found = index_.find(index);
+    if (found != index_.end()) {
+        blocks_.splice(blocks_.begin(), blocks_, found->second);
+    } else {
+        if (blocks_.size() < capacity_) {
+            blocks_.push_front(Block{index, false, std::vector<std::uint64_t>(blockWords_)});
+        } else {
+            // Reuse the least recently used block's buffer
+            Block& victim = blocks_.back();
+            if (victim.dirty) {
+                ok_ = store(victim) && ok_;
+            }
+            index_.erase(victim.index);
+            blocks_.splice(blocks_.begin(), blocks_, std::prev(blocks_.end()));
+            ++evictions_;
+        }
+        Block& block = blocks_.front();
+        block.index = index;
+        block.dirty = false;
+        ok_ = load(block) && ok_;
+        index_[index] = blocks_.begin();
+        ++loads_;
+    }
+    lastIndex_ = index;
+    last_ = &blocks_.front();
+    return last_;
+}
+
+// Short reads past the end of the file leave zeros
+bool TileCache::load(Block& block) {
+    std::size_t bytes = blockWords_ * sizeof(std::uint64_t);
+    char* data = reinterpret_cast<char*>(block.words.data());
+    off_t position = static_cast<off_t>(offset_ + static_cast<std::uint64_t>(block.index) * bytes);
+    std::size_t done = 0;
+    while (done < bytes) {
+        ssize_t got = pread(fd_, data + done, bytes - done, position + static_cast<off_t>(done));
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+        if (got <= 0) {
+            std::fill(data + done, data + bytes, 0);
+            return got == 0;
+        }
+        done += static_cast<std::size_t>(got);
+    }
+    return true;
+}
+
+bool TileCache::store(Block& block) {
+    std::size_t bytes = blockWords_ * sizeof(std::uint64_t);
+    const char* data = reinterpret_cast<const char*>(block.words.data());
+    off_t position = static_cast<off_t>(offset_ + static_cast<std::uint64_t>(block.index) * bytes);
+    std::size_t done = 0;
+    while (done < bytes) {
+        ssize_t put = pwrite(fd_, data + done, bytes - done, position + static_cast<off_t>(done));
+        if (put < 0 && errno == EINTR) {
+            continue;
+        }
+        if (put <= 0) {
+            return false;
+        }
+        done += static_cast<std::size_t>(put);
+    }
+    block.dirty = false;
+    ++writeBacks_;
+    return true;
+}
+
+bool TileCache::flush() {
+    for (Block& block : blocks_) {
+        if (block.dirty) {
+            ok_ = store(block) && ok_;
+        }
+    }
+    return ok_;
+}
@@ -0,0 +1,205 @@
+#include "../include/tiled_maze.h"
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+bool validTileSize(int tileSize) {
+    return tileSize >= 64 && tileSize <= 4096 && (tileSize & (tileSize - 1)) == 0;
+}
+
+int shiftOf(int value) {
+    int shift = 0;
+    while ((1 << shift) < value) {
+        ++shift;
+    }
+    return shift;
+}
+
+} // namespace
+
+bool isTiledMaze(const std::string& filename) {
+    std::FILE* file = std::fopen(filename.c_str(), "rb");
+    if (file == nullptr) {
+        return false;
+    }
+    char magic[sizeof(kTiledMazeMagic)];
+    bool tiled = std::fread(magic, sizeof(magic), 1, file) == 1 && std::memcmp(magic, kTiledMazeMagic, sizeof(magic)) == 0;
+    std::fclose(file);
+    return tiled;
+}
+
+TiledMazeWriter::TiledMazeWriter()
+    : file_(nullptr), width_(0), height_(0), tileSize_(0), tilesX_(0), rowsWritten_(0), bandRows_(0), ok_(false) {}
+
+TiledMazeWriter::~TiledMazeWriter() {
+    if (file_ != nullptr) {
+        std::fclose(file_);
+    }
+}
+
+bool TiledMazeWriter::open(const std::string& filename, std::int64_t width, std::int64_t height, int tileSize,
+                           const LargeCoordinates& start, const LargeCoordinates& end) {
+    if (!tiledMazeFits(width, height) || !validTileSize(tileSize)) {
+        std::cerr << "Error: Invalid tiled maze size " << width << "x" << height << " with tiles of " << tileSize
+                  << std::endl;
+        return false;
+    }
+    file_ = std::fopen(filename.c_str(), "wb");
+    if (file_ == nullptr) {
+        std::cerr << "Error: Could not open file " << filename << " for writing" << std::endl;
+        return false;
+    }
+    filename_ = filename;
+    width_ = width;
+    height_ = height;
+    tileSize_ = tileSize;
+    tilesX_ = (width + tileSize - 1) / tileSize;
+    rowsWritten_ = 0;
+    bandRows_ = 0;
+    band_.assign(static_cast<std::size_t>(tileSize) * tilesX_ * (tileSize / 64), ~std::uint64_t(0));
+    tile_.resize(static_cast<std::size_t>(tileSize) * (tileSize / 64));
+
+    TiledMazeHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kTiledMazeMagic, sizeof(kTiledMazeMagic));
+    header.version = kTiledMazeVersion;
+    header.width = width;
+    header.height = height;
+    header.tileSize = static_cast<std::uint32_t>(tileSize);
+    header.startX = start.first;
+    header.startY = start.second;
+    header.endX = end.first;
+    header.endY = end.second;
+    ok_ = std::fwrite(&header, sizeof(header), 1, file_) == 1;
+    return ok_;
+}
+
+bool TiledMazeWriter::writeRow(const std::uint64_t* words) {
+    if (file_ == nullptr || rowsWritten_ >= height_) {
+        return false;
+    }
+    std::size_t rowWords = static_cast<std::size_t>(tilesX_) * (tileSize_ / 64);
+    std::uint64_t* row = &band_[bandRows_ * rowWords];
+    std::size_t wordsPerRow = static_cast<std::size_t>((width_ + 63) / 64);
+    std::copy(words, words + wordsPerRow, row);
+    // Cells past the right edge stay walls
+    if (width_ & 63) {
+        row[wordsPerRow - 1] |= ~std::uint64_t(0) << (width_ & 63);
+    }
+    std::fill(row + wordsPerRow, row + rowWords, ~std::uint64_t(0));
+    ++rowsWritten_;
+    if (++bandRows_ == tileSize_) {
+        return writeBand();
+    }
+    return ok_;
+}
+
+// Split the band into its row of tiles, which are consecutive in the file
+bool TiledMazeWriter::writeBand() {
+    std::size_t tileWords = static_cast<std::size_t>(tileSize_ / 64);
+    std::size_t rowWords = static_cast<std::size_t>(tilesX_) * tileWords;
+    for (std::int64_t tile = 0; tile < tilesX_ && ok_; ++tile) {
+        for (int row = 0; row < tileSize_; ++row) {
+            const std::uint64_t* source = &band_[row * rowWords + tile * tileWords];
+            std::copy(source, source + tileWords, &tile_[row * tileWords]);
+        }
+        ok_ = std::fwrite(tile_.data(), sizeof(std::uint64_t), tile_.size(), file_) == tile_.size();
+    }
+    std::fill(band_.begin(), band_.end(), ~std::uint64_t(0));
+    bandRows_ = 0;
+    return ok_;
+}
+
+bool TiledMazeWriter::close() {
+    if (file_ == nullptr) {
+        return false;
+    }
+    if (bandRows_ > 0) {
+        writeBand();
+    }
+    bool complete = rowsWritten_ == height_;
+    ok_ = std::fclose(file_) == 0 && ok_;
+    file_ = nullptr;
+    if (!ok_) {
+        std::cerr << "Error: Could not write " << filename_ << std::endl;
+    } else if (!complete) {
+        std::cerr << "Error: " << filename_ << " closed after " << rowsWritten_ << " of " << height_ << " rows"
+                  << std::endl;
+    }
+    return ok_ && complete;
+}
+
+bool writeTiledMaze(const std::string& filename, const WallBitmap& walls, int tileSize,
+                    const LargeCoordinates& start, const LargeCoordinates& end) {
+    TiledMazeWriter writer;
+    if (!writer.open(filename, walls.width(), walls.height(), tileSize, start, end)) {
+        return false;
+    }
+    for (int y = 0; y < walls.height(); ++y) {
+        if (!writer.writeRow(walls.row(y))) {
+            break;
+        }
+    }
+    return writer.close();
+}
+
+TiledMaze::TiledMaze() : width_(0), height_(0), tileSize_(0), tileShift_(0), tilesX_(0), tilesY_(0) {}
+
+bool TiledMaze::open(const std::string& filename, std::size_t cacheBytes) {
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Error: Could not open file " << filename << std::endl;
+        return false;
+    }
+    TiledMazeHeader header;
+    struct stat info;
+    if (pread(fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)) || fstat(fd, &info) != 0 ||
+        std::memcmp(header.magic, kTiledMazeMagic, sizeof(kTiledMazeMagic)) != 0) {
+        std::cerr << "Error: " << filename << " is not a tiled maze" << std::endl;
+        ::close(fd);
+        return false;
+    }
+    if (header.version != kTiledMazeVersion) {
+        std::cerr << "Error: Unsupported tiled maze version " << header.version << " in " << filename << std::endl;
+        ::close(fd);
+        return false;
+    }
+    int tileSize = static_cast<int>(header.tileSize);
+    // Ids stay below 2^61, clear of overflow in y * width + x and of the
+    // search's id << 3 open-list entries
+    if (!tiledMazeFits(header.width, header.height) || !validTileSize(tileSize)) {
+        std::cerr << "Error: Invalid maze dimensions in " << filename << std::endl;
+        ::close(fd);
+        return false;
+    }
+    std::int64_t tilesX = (header.width + tileSize - 1) / tileSize;
+    std::int64_t tilesY = (header.height + tileSize - 1) / tileSize;
+    std::uint64_t tileBytes = static_cast<std::uint64_t>(tileSize) * tileSize / 8;
+    if (static_cast<std::uint64_t>(info.st_size) < sizeof(header) + tileBytes * tilesX * tilesY) {
+        std::cerr << "Error: Truncated tiled maze file " << filename << std::endl;
+        ::close(fd);
+        return false;
+    }
+    if (header.startX < 0 || header.startX >= header.width || header.startY < 0 || header.startY >= header.height ||
+        header.endX < 0 || header.endX >= header.width || header.endY < 0 || header.endY >= header.height) {
+        std::cerr << "Error: Invalid coordinates in " << filename << std::endl;
+        ::close(fd);
+        return false;
+    }
+
+    width_ = header.width;
+    height_ = header.height;
+    tileSize_ = tileSize;
+    tileShift_ = shiftOf(tileSize);
+    tilesX_ = tilesX;
+    tilesY_ = tilesY;
+    start_ = LargeCoordinates(header.startX, header.startY);
+    end_ = LargeCoordinates(header.endX, header.endY);
+    tiles_.open(fd, sizeof(header), static_cast<std::size_t>(tileBytes / sizeof(std::uint64_t)), cacheBytes);
+    return true;
+}
@@ -0,0 +1,223 @@
+#include "../include/tiled_search.h"
+#include "../include/types.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <unistd.h>
+
+namespace {
+
+// Per-cell state, half a byte: unseen, the direction moved to reach the
+// cell plus one, or the start
+const unsigned kUnseen = 0;
+const unsigned kStartCell = 5;
+
+// Unlinked at once, so the file goes away with the descriptor
+int createScratchFile() {
+    const char* directory = std::getenv("TMPDIR");
+    std::string pattern = std::string(directory != nullptr && *directory ? directory : "/tmp") + "/maze_search_XXXXXX";
+    std::vector<char> name(pattern.begin(), pattern.end());
+    name.push_back('\0');
+    int fd = mkstemp(name.data());
+    if (fd >= 0) {
+        unlink(name.data());
+    }
+    return fd;
+}
+
+// Search state in tiles laid out like the maze's, so a cell's walls and
+// state are paged in together
+class SearchState {
+public:
+    explicit SearchState(const TiledMaze& maze) : maze_(maze) {}
+
+    bool open(std::size_t budgetBytes) {
+        int fd = createScratchFile();
+        if (fd < 0) {
+            return false;
+        }
+        std::size_t tileWords = static_cast<std::size_t>(maze_.tileSize()) * maze_.tileSize() / 16;
+        cache_.open(fd, 0, tileWords, budgetBytes);
+        return true;
+    }
+
+    unsigned get(std::int64_t x, std::int64_t y) {
+        const unsigned char* cells = reinterpret_cast<const unsigned char*>(cache_.read(maze_.tileIndex(x, y)));
+        std::size_t cell = cellOffset(x, y);
+        return (cells[cell >> 1] >> ((cell & 1) * 4)) & 15u;
+    }
+
+    void set(std::int64_t x, std::int64_t y, unsigned value) {
+        unsigned char* cells = reinterpret_cast<unsigned char*>(cache_.write(maze_.tileIndex(x, y)));
+        std::size_t cell = cellOffset(x, y);
+        unsigned shift = (cell & 1) * 4;
+        cells[cell >> 1] = static_cast<unsigned char>((cells[cell >> 1] & ~(15u << shift)) | (value << shift));
+    }
+
+    const TileCache& cache() const { return cache_; }
+
+private:
+    std::size_t cellOffset(std::int64_t x, std::int64_t y) const {
+        std::int64_t mask = maze_.tileSize() - 1;
+        return static_cast<std::size_t>((y & mask) * maze_.tileSize() + (x & mask));
+    }
+
+    const TiledMaze& maze_;
+    TileCache cache_;
+};
+
+bool searchBFS(TiledMaze& maze, SearchState& state, TiledSearchStats& stats) {
+    std::int64_t width = maze.width();
+    std::int64_t endId = maze.cellId(maze.end().first, maze.end().second);
+    std::vector<std::int64_t> layer(1, maze.cellId(maze.start().first, maze.start().second));
+    std::vector<std::int64_t> next;
+    state.set(maze.start().first, maze.start().second, kStartCell);
+    stats.pushes = 1;
+    stats.peakFrontier = 1;
+
+    // Level by level, so the open list is two plain vectors
+    while (!layer.empty()) {
+        for (std::int64_t id : layer) {
+            ++stats.openedNodes;
+            if (id == endId) {
+                return true;
+            }
+            std::int64_t x = id % width;
+            std::int64_t y = id / width;
+            for (int d = 0; d < 4; ++d) {
+                std::int64_t nextX = x + directions[d].first;
+                std::int64_t nextY = y + directions[d].second;
+                if (!maze.isWall(nextX, nextY) && state.get(nextX, nextY) == kUnseen) {
+                    state.set(nextX, nextY, d + 1);
+                    next.push_back(maze.cellId(nextX, nextY));
+                    ++stats.pushes;
+                }
+            }
+        }
+        stats.peakFrontier = std::max(stats.peakFrontier, static_cast<long long>(next.size()));
+        layer.swap(next);
+        next.clear();
+    }
+    return false;
+}
+
+bool searchAStar(TiledMaze& maze, SearchState& state, TiledSearchStats& stats) {
+    std::int64_t width = maze.width();
+    LargeCoordinates end = maze.end();
+    std::int64_t endId = maze.cellId(end.first, end.second);
+    auto heuristic = [&](std::int64_t x, std::int64_t y) {
+        return std::llabs(x - end.first) + std::llabs(y - end.second);
+    };
+
+    // Entries are a cell id shifted past the direction it was reached by (4
+    // for the start). A move changes g + h by 0 or 2, so the open list only
+    // ever holds the smallest f and f + 2: two stacks, the second taking
+    // over when the first runs dry. Cells are closed, and their parent
+    // fixed, when first popped; later entries for them are skipped.
+    std::int64_t startId = maze.cellId(maze.start().first, maze.start().second);
+    std::vector<std::uint64_t> current(1, static_cast<std::uint64_t>(startId) << 3 | 4);
+    std::vector<std::uint64_t> deeper;
+    stats.pushes = 1;
+    stats.peakFrontier = 1;
+
+    while (!current.empty() || !deeper.empty()) {
+        if (current.empty()) {
+            current.swap(deeper);
+        }
+        std::uint64_t entry = current.back();
+        current.pop_back();
+        std::int64_t id = static_cast<std::int64_t>(entry >> 3);
+        std::int64_t x = id % width;
+        std::int64_t y = id / width;
+        if (state.get(x, y) != kUnseen) {
+            continue;
+        }
+        state.set(x, y, static_cast<unsigned>(entry & 7) + 1);
+        ++stats.openedNodes;
+        if (id == endId) {
+            return true;
+        }
+
+        std::int64_t h = heuristic(x, y);
+        for (int d = 0; d < 4; ++d) {
+            std::int64_t nextX = x + directions[d].first;
+            std::int64_t nextY = y + directions[d].second;
+            if (!maze.isWall(nextX, nextY) && state.get(nextX, nextY) == kUnseen) {
+                std::uint64_t next = static_cast<std::uint64_t>(maze.cellId(nextX, nextY)) << 3 | static_cast<unsigned>(d);
+                (heuristic(nextX, nextY) < h ? current : deeper).push_back(next);
+                ++stats.pushes;
+            }
+        }
+        stats.peakFrontier = std::max(stats.peakFrontier, static_cast<long long>(current.size() + deeper.size()));
+    }
+    return false;
+}
+
+} // namespace
+
+bool parseTiledEngine(const std::string& key, TiledEngine& engine) {
+    if (key == "bfs") {
+        engine = TILED_BFS;
+    } else if (key == "astar") {
+        engine = TILED_ASTAR;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool findPathTiled(TiledMaze& maze, TiledEngine engine, std::size_t stateBudgetBytes, TiledSearchStats& stats,
+                   std::vector<LargeCoordinates>* path) {
+    stats = TiledSearchStats();
+    stats.ioOk = true;
+    if (path != nullptr) {
+        path->clear();
+    }
+    LargeCoordinates start = maze.start();
+    LargeCoordinates end = maze.end();
+    if (maze.isWall(start.first, start.second) || maze.isWall(end.first, end.second)) {
+        return false;
+    }
+    SearchState state(maze);
+    if (!state.open(stateBudgetBytes)) {
+        std::cerr << "Error: Could not create a scratch file for the search state" << std::endl;
+        stats.ioOk = false;
+        return false;
+    }
+
+    stats.found = engine == TILED_BFS ? searchBFS(maze, state, stats) : searchAStar(maze, state, stats);
+    if (stats.found) {
+        // Back along the parent directions; the path may be long, so it is
+        // only counted unless asked for
+        std::int64_t x = end.first;
+        std::int64_t y = end.second;
+        stats.pathLength = 1;
+        for (unsigned value = state.get(x, y); value != kStartCell; value = state.get(x, y)) {
+            if (value == kUnseen || value > 4) {
+                // Only a failed tile read leaves a gap in the parents
+                stats.found = false;
+                stats.pathLength = 0;
+                if (path != nullptr) {
+                    path->clear();
+                }
+                break;
+            }
+            if (path != nullptr) {
+                path->push_back(LargeCoordinates(x, y));
+            }
+            x -= directions[value - 1].first;
+            y -= directions[value - 1].second;
+            ++stats.pathLength;
+        }
+        if (path != nullptr && stats.found) {
+            path->push_back(start);
+            std::reverse(path->begin(), path->end());
+        }
+    }
+
+    stats.stateLoads = state.cache().loads();
+    stats.stateWriteBacks = state.cache().writeBacks();
+    stats.stateBytes = state.cache().memoryBytes();
+    stats.ioOk = state.cache().ok() && maze.cache().ok();
+    return stats.found;
+}